@@ -0,0 +1,282 @@
+#ifndef BATCH_SEARCH_HPP
+#define BATCH_SEARCH_HPP
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "search.hpp"
+
+namespace search {
+
+namespace detail {
+
+template <typename Index, typename Key, typename = void>
+struct HasBatchLowerBound : std::false_type {};
+
+template <typename Index, typename Key>
+struct HasBatchLowerBound<Index, Key, std::void_t<decltype(std::declval<const Index&>().lowerBoundBatch(
+    std::declval<const Key*>(), std::size_t(0), std::declval<std::size_t*>()))>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Lower bound of many keys in one sorted array, with group prefetching.
+ *
+ * With the branchless kernel every search over n elements takes the same
+ * number of steps, so kBatchGroup searches advance in lockstep: each step
+ * updates all of them and then prefetches each one's next probe. Up to
+ * kBatchGroup cache misses are in flight at once instead of one.
+ *
+ * @param first, last The sorted array.
+ * @param queries, count Keys to look up, in any order.
+ * @param results Receives the lower-bound index of queries[i] at index i.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+void lowerBoundBatch(Branchless, RandomIt first, RandomIt last, const Key* queries, std::size_t count,
+                     std::size_t* results, Compare comp = {}) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n == 0) {
+        std::fill(results, results + count, std::size_t(0));
+        return;
+    }
+    std::size_t base[kBatchGroup];
+    for (std::size_t start = 0; start < count; start += kBatchGroup) {
+        std::size_t group = std::min(kBatchGroup, count - start);
+        const Key* keys = queries + start;
+        for (std::size_t i = 0; i < group; ++i) {
+            base[i] = 0;
+        }
+        std::size_t length = n;
+        while (length > 1) {
+            std::size_t half = length / 2;
+            for (std::size_t i = 0; i < group; ++i) {
+                base[i] = comp(first[base[i] + half], keys[i]) ? base[i] + half : base[i];
+            }
+            length -= half;
+            for (std::size_t i = 0; i < group; ++i) {
+                detail::prefetch(&first[base[i] + length / 2]);
+            }
+        }
+        for (std::size_t i = 0; i < group; ++i) {
+            results[start + i] = base[i] + (comp(first[base[i]], keys[i]) ? 1 : 0);
+        }
+    }
+}
+
+/// The classic kernel has no lockstep structure; this is the plain loop.
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+void lowerBoundBatch(Classic, RandomIt first, RandomIt last, const Key* queries, std::size_t count,
+                     std::size_t* results, Compare comp = {}) {
+    for (std::size_t i = 0; i < count; ++i) {
+        results[i] = static_cast<std::size_t>(search::lowerBound(first, last, queries[i], comp) - first);
+    }
+}
+
+/// The interpolation kernel's probes depend on each key's value, so it has no lockstep form either.
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+void lowerBoundBatch(Interpolation, RandomIt first, RandomIt last, const Key* queries, std::size_t count,
+                     std::size_t* results, Compare comp = {}) {
+    for (std::size_t i = 0; i < count; ++i) {
+        results[i] = static_cast<std::size_t>(
+            search::lowerBound(interpolation, first, last, queries[i], comp) - first);
+    }
+}
+
+/// The SIMD kernel counts a window per query; its narrowing already runs branchless, so this is the plain loop.
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+void lowerBoundBatch(Simd policy, RandomIt first, RandomIt last, const Key* queries, std::size_t count,
+                     std::size_t* results, Compare comp = {}) {
+    for (std::size_t i = 0; i < count; ++i) {
+        results[i] = static_cast<std::size_t>(search::lowerBound(policy, first, last, queries[i], comp) - first);
+    }
+}
+
+/**
+ * @brief Batch lower bound against a sorted range such as std::vector.
+ *
+ * @return results[i] is the lower-bound index of queries[i].
+ */
+template <typename Policy, typename Range, typename Key, typename Compare = std::less<>,
+          detail::EnableIfPolicyRange<Policy, Range> = 0>
+std::vector<std::size_t> lowerBoundBatch(Policy policy, const Range& sorted, const std::vector<Key>& queries,
+                                         Compare comp = {}) {
+    std::vector<std::size_t> results(queries.size());
+    search::lowerBoundBatch(policy, std::begin(sorted), std::end(sorted), queries.data(), queries.size(),
+                            results.data(), comp);
+    return results;
+}
+
+//-----------------------------------------------------------------------------
+// Strategies for large batches
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief How a batch is matched against the sorted array.
+ *
+ * Independent: each query is searched separately (interleaved branchless).
+ * Galloping:   queries are sorted, then each search starts at the previous
+ *              result and probes 1, 2, 4, ... ahead before a binary search.
+ * Merge:       queries are sorted and merged with the array in one pass.
+ * Auto:        pick one of the above with chooseBatchStrategy.
+ */
+enum class BatchStrategy { Independent, Galloping, Merge, Auto };
+
+/// Array elements per query at or below which a linear merge wins.
+inline constexpr std::size_t kMergeRatio = 8;
+/// Array elements per query at or below which galloping beats fresh searches.
+inline constexpr std::size_t kGallopRatio = 128;
+/// Arrays up to this size stay cached, so independent lookups are cheap
+/// enough that sorting an unsorted batch first never pays for itself.
+inline constexpr std::size_t kCacheResidentBytes = std::size_t(8) << 20;
+
+/**
+ * @brief Picks a strategy from the ratio of array size to batch size.
+ *
+ * The thresholds come from the 'strategy' suite in search_bench.cpp.
+ *
+ * @param arraySize Elements in the sorted array.
+ * @param batchSize Number of queries.
+ * @param queriesSorted Whether the queries are already in ascending order.
+ * @param elementBytes Size of one array element.
+ */
+inline BatchStrategy chooseBatchStrategy(std::size_t arraySize, std::size_t batchSize, bool queriesSorted,
+                                         std::size_t elementBytes = 4) {
+    if (arraySize == 0 || batchSize == 0) {
+        return BatchStrategy::Independent;
+    }
+    if (!queriesSorted && arraySize * elementBytes <= kCacheResidentBytes) {
+        return BatchStrategy::Independent;
+    }
+    std::size_t ratio = arraySize / batchSize;
+    if (ratio <= kMergeRatio) {
+        return BatchStrategy::Merge;
+    }
+    if (ratio <= kGallopRatio) {
+        return BatchStrategy::Galloping;
+    }
+    return BatchStrategy::Independent;
+}
+
+namespace detail {
+
+// Lower bound of key in [from, n), knowing the answer is at least `from`.
+// Probes from+1, from+2, from+4, ... to bracket it, then searches the bracket.
+template <typename RandomIt, typename Key, typename Compare>
+std::size_t gallopLowerBound(RandomIt first, std::size_t n, std::size_t from, const Key& key, Compare comp) {
+    if (from >= n || !comp(first[from], key)) {
+        return from;
+    }
+    std::size_t low = from;  // first[low] < key
+    std::size_t step = 1;
+    while (low + step < n && comp(first[low + step], key)) {
+        low += step;
+        step *= 2;
+    }
+    std::size_t high = std::min(n, low + step);
+    return static_cast<std::size_t>(
+        search::lowerBound(Branchless{}, first + low + 1, first + high, key, comp) - first);
+}
+
+// Query keys in ascending order, each with its position in the caller's batch
+template <typename Key, typename Compare>
+std::vector<std::pair<Key, std::size_t>> sortQueries(const Key* queries, std::size_t count, Compare comp) {
+    std::vector<std::pair<Key, std::size_t>> sorted(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        sorted[i] = {queries[i], i};
+    }
+    std::sort(sorted.begin(), sorted.end(), [&](const auto& a, const auto& b) { return comp(a.first, b.first); });
+    return sorted;
+}
+
+// Galloping or merge over queries visited in ascending order. keyAt(j) and
+// slotOf(j) give the j-th smallest query and where its result belongs.
+template <typename RandomIt, typename KeyAt, typename SlotOf, typename Compare>
+void sortedLowerBounds(BatchStrategy strategy, RandomIt first, std::size_t n, std::size_t count,
+                       KeyAt keyAt, SlotOf slotOf, std::size_t* results, Compare comp) {
+    std::size_t position = 0;
+    for (std::size_t j = 0; j < count; ++j) {
+        const auto& key = keyAt(j);
+        if (strategy == BatchStrategy::Merge) {
+            while (position < n && comp(first[position], key)) {
+                ++position;
+            }
+        } else {
+            position = gallopLowerBound(first, n, position, key, comp);
+        }
+        results[slotOf(j)] = position;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Batch lower bound using independent, galloping or merge matching.
+ *
+ * Galloping and Merge walk the queries in ascending order (sorting a copy
+ * first if needed), but results always come back in the caller's order:
+ * results[i] is the lower-bound index of queries[i].
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+void lowerBoundBatch(BatchStrategy strategy, RandomIt first, RandomIt last, const Key* queries,
+                     std::size_t count, std::size_t* results, Compare comp = {}) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    bool sorted = std::is_sorted(queries, queries + count, comp);
+    if (strategy == BatchStrategy::Auto) {
+        strategy = chooseBatchStrategy(n, count, sorted, sizeof(*first));
+    }
+
+    if (strategy == BatchStrategy::Independent) {
+        search::lowerBoundBatch(Branchless{}, first, last, queries, count, results, comp);
+    } else if (sorted) {
+        detail::sortedLowerBounds(strategy, first, n, count,
+                                  [&](std::size_t j) -> const Key& { return queries[j]; },
+                                  [](std::size_t j) { return j; }, results, comp);
+    } else {
+        auto order = detail::sortQueries(queries, count, comp);
+        detail::sortedLowerBounds(strategy, first, n, count,
+                                  [&](std::size_t j) -> const Key& { return order[j].first; },
+                                  [&](std::size_t j) { return order[j].second; }, results, comp);
+    }
+}
+
+template <typename Range, typename Key, typename Compare = std::less<>, detail::EnableIfRange<Range> = 0>
+std::vector<std::size_t> lowerBoundBatch(BatchStrategy strategy, const Range& sorted,
+                                         const std::vector<Key>& queries, Compare comp = {}) {
+    std::vector<std::size_t> results(queries.size());
+    search::lowerBoundBatch(strategy, std::begin(sorted), std::end(sorted), queries.data(), queries.size(),
+                            results.data(), comp);
+    return results;
+}
+
+//-----------------------------------------------------------------------------
+// Prebuilt indexes
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Batch lower bound against a prebuilt index (EytzingerIndex, STree, ...).
+ *
+ * Uses the index's interleaved lowerBoundBatch when it has one and falls
+ * back to one lowerBound call per query otherwise.
+ */
+template <typename Index, typename Key>
+void lowerBoundBatch(const Index& index, const Key* queries, std::size_t count, std::size_t* results) {
+    if constexpr (detail::HasBatchLowerBound<Index, Key>::value) {
+        index.lowerBoundBatch(queries, count, results);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = index.lowerBound(queries[i]);
+        }
+    }
+}
+
+template <typename Index, typename Key,
+          std::enable_if_t<!detail::IsPolicy<Index>::value && !std::is_same_v<Index, BatchStrategy>, int> = 0>
+std::vector<std::size_t> lowerBoundBatch(const Index& index, const std::vector<Key>& queries) {
+    std::vector<std::size_t> results(queries.size());
+    search::lowerBoundBatch(index, queries.data(), queries.size(), results.data());
+    return results;
+}
+
+} // namespace search
+
+#endif // BATCH_SEARCH_HPP
@@ -0,0 +1,163 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <vector>
+#include <algorithm> // For std::max
+#include <iterator>
+#include <type_traits>
+#include "search.hpp"
+
+namespace search {
+
+namespace detail {
+
+// The key type of an index template such as EytzingerIndex<T, Compare>
+template <typename Index>
+struct IndexKeyOf;
+
+template <template <typename...> class Index, typename T, typename... Rest>
+struct IndexKeyOf<Index<T, Rest...>> {
+    using type = T;
+};
+
+} // namespace detail
+
+/**
+ * @brief Blocked Bloom filter: one cache line per lookup.
+ *
+ * A key's hash picks one 64-byte block, and sets one bit in each of the
+ * block's eight 64-bit words, each bit chosen by multiplying the hash by a
+ * different odd constant ("split block" filter). A query reads that one
+ * line; if any of the eight bits is clear, the key was never inserted.
+ *
+ * At the default 12 bits per key about 0.4% of absent keys pass, against
+ * about 0.3% for a classic Bloom filter of the same size, whose probes are
+ * spread over k cache lines.
+ */
+class BlockedBloomFilter {
+public:
+    static constexpr std::size_t kDefaultBitsPerKey = 12;
+
+    BlockedBloomFilter() = default;
+
+    /// An empty filter sized for keys insertions at bitsPerKey bits each.
+    explicit BlockedBloomFilter(std::size_t keys, std::size_t bitsPerKey = kDefaultBitsPerKey)
+        : blocks_(std::max<std::size_t>(1, (keys * bitsPerKey + kBlockBits - 1) / kBlockBits)) {}
+
+    void insertHash(std::uint64_t hash) {
+        Block& block = blocks_[blockOf(hash)];
+        for (int word = 0; word < kWords; ++word) {
+            block.words[word] |= bitOf(hash, word);
+        }
+    }
+
+    /// False only if no hash equal to hash was inserted.
+    bool mayContainHash(std::uint64_t hash) const {
+        const Block& block = blocks_[blockOf(hash)];
+        std::uint64_t missing = 0;
+        for (int word = 0; word < kWords; ++word) {
+            missing |= bitOf(hash, word) & ~block.words[word];
+        }
+        return missing == 0;
+    }
+
+    template <typename Key>
+    void insert(const Key& key) { insertHash(detail::hashKey(key)); }
+
+    /// False only if key was never inserted.
+    template <typename Key>
+    bool mayContain(const Key& key) const { return mayContainHash(detail::hashKey(key)); }
+
+    std::size_t memoryBytes() const { return blocks_.size() * sizeof(Block); }
+
+private:
+    static constexpr int kWords = 8;
+    static constexpr std::size_t kBlockBits = 512;
+
+    struct alignas(64) Block {
+        std::uint64_t words[kWords];
+    };
+
+    std::vector<Block, detail::AlignedAllocator<Block>> blocks_;
+
+    // The high 32 bits scaled to the block count, without a division
+    std::size_t blockOf(std::uint64_t hash) const {
+        return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(blocks_.size())) >> 32);
+    }
+
+    // Bit of word from the low 32 bits times that word's odd constant
+    static std::uint64_t bitOf(std::uint64_t hash, int word) {
+        static constexpr std::uint32_t kSalt[kWords] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        std::uint32_t spread = static_cast<std::uint32_t>(hash) * kSalt[word];
+        return std::uint64_t(1) << (spread >> 26);
+    }
+};
+
+/**
+ * @brief An index with a Bloom filter in front of its exact-match lookups.
+ *
+ * find() and contains() first ask the filter, which turns most absent keys
+ * away after one cache line instead of a full search; keys that pass go on
+ * to the index. lowerBound() and upperBound() always search, since a miss
+ * still has a position.
+ *
+ * Keys that the index's ordering treats as equivalent must be equal and
+ * hash alike (true for the default ordering of numbers and strings).
+ *
+ * @tparam Index Any index constructible from a sorted range, such as
+ *         EytzingerIndex, STree or SearchIndex.
+ */
+template <typename Index>
+class FilteredIndex {
+public:
+    FilteredIndex() = default;
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit FilteredIndex(const Range& sorted, std::size_t bitsPerKey = BlockedBloomFilter::kDefaultBitsPerKey)
+        : index_(sorted),
+          filter_(static_cast<std::size_t>(std::distance(std::begin(sorted), std::end(sorted))), bitsPerKey) {
+        for (const auto& key : sorted) {
+            filter_.insert(static_cast<const IndexKey&>(key));
+        }
+    }
+
+    std::size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+
+    template <typename Key>
+    std::size_t lowerBound(const Key& key) const { return index_.lowerBound(key); }
+
+    template <typename Key>
+    std::size_t upperBound(const Key& key) const { return index_.upperBound(key); }
+
+    /// The index's find(key), or search::npos as soon as the filter rules key out.
+    template <typename Key>
+    std::size_t find(const Key& key) const {
+        // Hash as the stored key type, so a probe of another type (a
+        // string literal, a narrower integer) hashes like the stored key
+        bool mayContain;
+        if constexpr (std::is_same_v<Key, IndexKey>) {
+            mayContain = filter_.mayContain(key);
+        } else {
+            mayContain = filter_.mayContain(IndexKey(key));
+        }
+        return mayContain ? index_.find(key) : npos;
+    }
+
+    template <typename Key>
+    bool contains(const Key& key) const { return find(key) != npos; }
+
+    const Index& index() const { return index_; }
+    const BlockedBloomFilter& filter() const { return filter_; }
+
+private:
+    using IndexKey = typename detail::IndexKeyOf<Index>::type;
+
+    Index index_;
+    BlockedBloomFilter filter_;
+};
+
+} // namespace search
+
+#endif // BLOOM_FILTER_HPP
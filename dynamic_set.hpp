@@ -0,0 +1,236 @@
+#ifndef DYNAMIC_SET_HPP
+#define DYNAMIC_SET_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "search.hpp"
+
+namespace search {
+
+/**
+ * @brief Sorted multiset with cheap inserts, built from sorted runs.
+ *
+ * Inserts go into a small sorted buffer. When it fills, it is merged into
+ * a ladder of runs whose sizes are the buffer size times powers of two:
+ * like a binary counter, the buffer merges with run 0, the result with run
+ * 1 if that is occupied, and so on, until it lands in an empty slot. Each
+ * element is merged O(log n) times, so inserts cost O(log n) amortized and
+ * never re-sort anything.
+ *
+ * A lookup searches the buffer and every run, O(log^2 n) in all. With
+ * fractional cascading each run also keeps, for every kCascadeStride-th
+ * element, its lower bound in the next occupied run. Only the smallest run
+ * is searched in full; in each larger one the bridges narrow the search to
+ * the keys between two samples of the run before it. Bridges only sample
+ * the smaller run, so that window is not bounded by the stride alone:
+ * - When the runs interleave evenly, as with random inserts, it holds about
+ *   kCascadeStride << gap keys, where gap is how many levels lie between the
+ *   two runs. Runs 0 and 10 occupied gives about 8K keys. The gaps add up to
+ *   at most the number of levels, so a lookup still makes
+ *   O(log n + runs * log(stride)) comparisons, but a wide window costs cache
+ *   misses that a few strides would not.
+ * - When a run's keys all fall between two samples of the smaller run, the
+ *   window is the whole run and the lookup degrades to O(log^2 n).
+ */
+template <typename T, typename Compare = std::less<>>
+class DynamicSortedSet {
+public:
+    /// Capacity of the insert buffer and size of the smallest run.
+    static constexpr std::size_t kBufferKeys = 256;
+    /// Run elements per fractional-cascading bridge.
+    static constexpr std::size_t kCascadeStride = 8;
+
+    /**
+     * @param fractionalCascading Keep bridges between runs to speed up
+     *        lookups, at the cost of extra work after each merge.
+     * @param comp The ordering of the elements.
+     */
+    explicit DynamicSortedSet(bool fractionalCascading = false, Compare comp = {})
+        : comp_(comp), cascading_(fractionalCascading) {
+        buffer_.reserve(kBufferKeys);
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /// Occupied runs, not counting the insert buffer.
+    std::size_t runCount() const {
+        return static_cast<std::size_t>(
+            std::count_if(runs_.begin(), runs_.end(), [](const Run& run) { return !run.keys.empty(); }));
+    }
+
+    void insert(const T& key) {
+        buffer_.insert(std::upper_bound(buffer_.begin(), buffer_.end(), key, comp_), key);
+        ++size_;
+        if (buffer_.size() == kBufferKeys) {
+            flushBuffer();
+        }
+    }
+
+    /// Number of elements ordered before key.
+    std::size_t rank(const T& key) const {
+        std::size_t count = static_cast<std::size_t>(
+            search::lowerBound(branchless, buffer_.begin(), buffer_.end(), key, comp_) - buffer_.begin());
+        forEachRunLowerBound(key, [&](const Run&, std::size_t position) { count += position; });
+        return count;
+    }
+
+    bool contains(const T& key) const { return findIn(key) != nullptr; }
+
+    /**
+     * @brief Smallest element not ordered before key.
+     *
+     * @return Pointer to it, or nullptr if none. Valid until the next insert.
+     */
+    const T* lowerBound(const T& key) const {
+        const T* best = nullptr;
+        auto consider = [&](const T* candidate) {
+            if (!best || comp_(*candidate, *best)) {
+                best = candidate;
+            }
+        };
+        auto inBuffer = search::lowerBound(branchless, buffer_.begin(), buffer_.end(), key, comp_);
+        if (inBuffer != buffer_.end()) {
+            consider(&*inBuffer);
+        }
+        forEachRunLowerBound(key, [&](const Run& run, std::size_t position) {
+            if (position < run.keys.size()) {
+                consider(&run.keys[position]);
+            }
+        });
+        return best;
+    }
+
+    /// All elements in order.
+    std::vector<T> toVector() const {
+        std::vector<T> all(buffer_);
+        for (const Run& run : runs_) {
+            std::vector<T> merged;
+            merged.reserve(all.size() + run.keys.size());
+            std::merge(all.begin(), all.end(), run.keys.begin(), run.keys.end(), std::back_inserter(merged), comp_);
+            all.swap(merged);
+        }
+        return all;
+    }
+
+    /// Bytes held by the buffer, the runs and their bridges.
+    std::size_t memoryBytes() const {
+        std::size_t bytes = buffer_.capacity() * sizeof(T);
+        for (const Run& run : runs_) {
+            bytes += run.keys.capacity() * sizeof(T) + run.bridges.capacity() * sizeof(std::size_t);
+        }
+        return bytes;
+    }
+
+private:
+    struct Run {
+        std::vector<T> keys;
+        // bridges[s] is the lower bound of keys[s * kCascadeStride] in the
+        // next occupied run; the last entry is that run's size
+        std::vector<std::size_t> bridges;
+    };
+
+    Compare comp_{};
+    bool cascading_ = false;
+    std::size_t size_ = 0;
+    std::vector<T> buffer_;
+    std::vector<Run> runs_; // runs_[k] is empty or holds kBufferKeys << k elements
+
+    void flushBuffer() {
+        std::vector<T> carry;
+        carry.swap(buffer_);
+        buffer_.reserve(kBufferKeys);
+        std::size_t level = 0;
+        for (;; ++level) {
+            if (level == runs_.size()) {
+                runs_.emplace_back();
+            }
+            Run& run = runs_[level];
+            if (run.keys.empty()) {
+                run.keys.swap(carry);
+                break;
+            }
+            std::vector<T> merged;
+            merged.reserve(run.keys.size() + carry.size());
+            std::merge(run.keys.begin(), run.keys.end(), carry.begin(), carry.end(), std::back_inserter(merged),
+                       comp_);
+            carry.swap(merged);
+            std::vector<T>().swap(run.keys);
+            std::vector<std::size_t>().swap(run.bridges);
+        }
+        if (cascading_) {
+            // Runs up to the new one changed, and so did the target of the
+            // bridges of the occupied runs below it
+            for (std::size_t k = 0; k <= level; ++k) {
+                buildBridges(k);
+            }
+        }
+    }
+
+    std::size_t nextOccupied(std::size_t k) const {
+        for (++k; k < runs_.size(); ++k) {
+            if (!runs_[k].keys.empty()) {
+                return k;
+            }
+        }
+        return runs_.size();
+    }
+
+    void buildBridges(std::size_t k) {
+        Run& run = runs_[k];
+        run.bridges.clear();
+        std::size_t next = nextOccupied(k);
+        if (run.keys.empty() || next == runs_.size()) {
+            return;
+        }
+        const std::vector<T>& target = runs_[next].keys;
+        std::size_t position = 0;
+        for (std::size_t s = 0; s * kCascadeStride < run.keys.size(); ++s) {
+            // Samples ascend, so each search starts where the last one ended
+            position = static_cast<std::size_t>(
+                search::lowerBound(branchless, target.begin() + position, target.end(),
+                                   run.keys[s * kCascadeStride], comp_) - target.begin());
+            run.bridges.push_back(position);
+        }
+        run.bridges.push_back(target.size());
+    }
+
+    // Calls visit(run, lowerBound of key in run) for every occupied run,
+    // smallest first, narrowing each search with the previous run's bridges
+    template <typename Visit>
+    void forEachRunLowerBound(const T& key, Visit visit) const {
+        std::size_t low = 0;
+        std::size_t high = npos; // Window in the current run from the previous bridges
+        for (std::size_t k = 0; k < runs_.size(); ++k) {
+            const Run& run = runs_[k];
+            if (run.keys.empty()) {
+                continue;
+            }
+            std::size_t end = std::min(high, run.keys.size());
+            std::size_t position = static_cast<std::size_t>(
+                search::lowerBound(branchless, run.keys.begin() + low, run.keys.begin() + end, key, comp_) -
+                run.keys.begin());
+            visit(run, position);
+
+            if (cascading_ && !run.bridges.empty()) {
+                // keys[position - 1] < key <= keys[position] bounds the next run's answer
+                low = position == 0 ? 0 : run.bridges[(position - 1) / kCascadeStride];
+                std::size_t upper = (position + kCascadeStride - 1) / kCascadeStride;
+                high = run.bridges[std::min(upper, run.bridges.size() - 1)];
+            } else {
+                low = 0;
+                high = npos;
+            }
+        }
+    }
+
+    const T* findIn(const T& key) const {
+        const T* candidate = lowerBound(key);
+        return (candidate && !comp_(key, *candidate)) ? candidate : nullptr;
+    }
+};
+
+} // namespace search
+
+#endif // DYNAMIC_SET_HPP
@@ -0,0 +1,260 @@
+#ifndef ELIAS_FANO_HPP
+#define ELIAS_FANO_HPP
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include "search.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace search {
+
+namespace detail {
+
+inline int popCount64(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Position of the rank-th (0-based) set bit of word, which must have more
+// than rank bits set. BMI2 deposits a single bit at that position with pdep.
+inline int selectInWord(std::uint64_t word, int rank) {
+#if defined(__BMI2__)
+    return countTrailingZeros(_pdep_u64(std::uint64_t(1) << rank, word));
+#else
+    for (int i = 0; i < rank; ++i) {
+        word &= word - 1;
+    }
+    return countTrailingZeros(word);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Elias-Fano encoding of a sorted sequence of integers.
+ *
+ * Each value, taken relative to the smallest, is split into its low
+ * `lowBits` bits, stored packed in one array, and its high part, stored in
+ * unary: value i sets bit high(i) + i of the upper bitvector. With lowBits =
+ * floor(log2(universe / n)) that is at most 2 + log2(universe / n) bits per
+ * value, less than two bits above the information-theoretic minimum for a
+ * set of n values from the universe.
+ *
+ * access(i) finds the i-th set bit of the upper bits (select1); nextGeq(x)
+ * finds where the bucket of x's high part starts (select0) and scans that
+ * bucket, which holds about one value on average. Both selects jump to a
+ * sampled position every kSelectSample bits of their kind, count whole words
+ * with popcount and finish in one word with pdep (BMI2) or a bit loop.
+ *
+ * Positions are 64-bit, so sequences of billions of values work, and the
+ * results match search::lowerBound / binarySearch on the sorted array.
+ */
+template <typename T>
+class EliasFano {
+    static_assert(std::is_integral_v<T>, "EliasFano encodes integer values");
+
+public:
+    /// Set bits (or clear bits) between select samples.
+    static constexpr std::size_t kSelectSample = 256;
+
+    EliasFano() = default;
+
+    /// Encodes values sorted in ascending order (duplicates allowed).
+    template <typename RandomIt>
+    EliasFano(RandomIt first, RandomIt last) : count_(static_cast<std::size_t>(last - first)) {
+        if (count_ == 0) {
+            return;
+        }
+        minimum_ = first[0];
+        std::uint64_t maxOffset = offsetOf(first[count_ - 1]);
+        std::uint64_t spacing = maxOffset / count_; // Average gap, universe / n
+        lowBits_ = spacing > 0 ? detail::floorLog2(spacing) : 0;
+        lowMask_ = lowBits_ == 0 ? 0 : (std::uint64_t(1) << lowBits_) - 1;
+
+        buckets_ = static_cast<std::size_t>(maxOffset >> lowBits_) + 1;
+        std::size_t upperBits = count_ + buckets_;
+        upper_.assign((upperBits + 63) / 64, 0);
+        lower_.assign((count_ * lowBits_ + 63) / 64 + 1, 0);
+        for (std::size_t i = 0; i < count_; ++i) {
+            std::uint64_t offset = offsetOf(first[i]);
+            std::size_t bit = static_cast<std::size_t>(offset >> lowBits_) + i;
+            upper_[bit / 64] |= std::uint64_t(1) << (bit % 64);
+            setLow(i, offset & lowMask_);
+        }
+
+        // Every bucket ends with a clear bit, so there are buckets_ of them
+        std::size_t ones = 0;
+        std::size_t zeros = 0;
+        for (std::size_t word = 0; word < upper_.size(); ++word) {
+            std::size_t valid = std::min<std::size_t>(64, upperBits - word * 64);
+            std::uint64_t oneBits = upper_[word];
+            std::uint64_t zeroBits = ~oneBits & (valid == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << valid) - 1);
+            ones = addSamples(selectOne_, oneBits, word, ones);
+            zeros = addSamples(selectZero_, zeroBits, word, zeros);
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit EliasFano(const Range& sorted) : EliasFano(std::begin(sorted), std::end(sorted)) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// The value at sorted position i.
+    T access(std::size_t i) const {
+        std::uint64_t high = static_cast<std::uint64_t>(selectOne(i) - i);
+        return valueOf((high << lowBits_) | low(i));
+    }
+
+    T operator[](std::size_t i) const { return access(i); }
+
+    /// Position of the first value >= x (size() if none); the same as rank(x).
+    std::size_t nextGeq(T x) const {
+        if (count_ == 0 || x <= minimum_) {
+            return 0;
+        }
+        std::uint64_t target = offsetOf(x);
+        std::uint64_t bucket = target >> lowBits_;
+        if (bucket >= buckets_) {
+            return count_;
+        }
+        // The bucket starts after the clear bit that ends the previous one
+        std::size_t bit = bucket == 0 ? 0 : selectZero(static_cast<std::size_t>(bucket - 1)) + 1;
+        std::size_t i = bit - static_cast<std::size_t>(bucket);
+        std::uint64_t targetLow = target & lowMask_;
+        while (upper_[bit / 64] >> (bit % 64) & 1) {
+            if (low(i) >= targetLow) {
+                return i;
+            }
+            ++i;
+            ++bit;
+        }
+        return i; // Every later value is in a higher bucket
+    }
+
+    /// Number of values less than x.
+    std::size_t rank(T x) const { return nextGeq(x); }
+
+    /// Index of the first value >= key (size() if none).
+    std::size_t lowerBound(T key) const { return nextGeq(key); }
+
+    /// Index of the first value > key (size() if none).
+    std::size_t upperBound(T key) const {
+        return key == std::numeric_limits<T>::max() ? count_ : nextGeq(key + 1);
+    }
+
+    /// Index of a value equal to key, or search::npos, as binarySearch.
+    std::size_t find(T key) const {
+        std::size_t position = nextGeq(key);
+        return (position < count_ && access(position) == key) ? position : npos;
+    }
+
+    bool contains(T key) const { return find(key) != npos; }
+
+    /// Bytes used by the low bits, the upper bitvector and both select samples.
+    std::size_t memoryBytes() const {
+        return (lower_.size() + upper_.size()) * sizeof(std::uint64_t) +
+               (selectOne_.size() + selectZero_.size()) * sizeof(std::size_t);
+    }
+
+    /// Low bits stored per value.
+    int lowBits() const { return lowBits_; }
+
+private:
+    using Unsigned = std::make_unsigned_t<T>;
+
+    std::size_t count_ = 0;
+    T minimum_{};
+    int lowBits_ = 0;
+    std::uint64_t lowMask_ = 0;
+    std::size_t buckets_ = 0;                   // Distinct high parts up to the largest value
+    std::vector<std::uint64_t> upper_;          // Unary high parts
+    std::vector<std::uint64_t> lower_;          // Packed low parts, plus a spare word
+    std::vector<std::size_t> selectOne_;        // Position of set bit k * kSelectSample
+    std::vector<std::size_t> selectZero_;       // Position of clear bit k * kSelectSample
+
+    std::uint64_t offsetOf(T value) const {
+        return static_cast<std::uint64_t>(static_cast<Unsigned>(static_cast<Unsigned>(value) -
+                                                                static_cast<Unsigned>(minimum_)));
+    }
+
+    T valueOf(std::uint64_t offset) const {
+        return static_cast<T>(static_cast<Unsigned>(static_cast<Unsigned>(minimum_) + static_cast<Unsigned>(offset)));
+    }
+
+    std::uint64_t low(std::size_t i) const {
+        if (lowBits_ == 0) {
+            return 0;
+        }
+        std::size_t bit = i * static_cast<std::size_t>(lowBits_);
+        std::size_t word = bit / 64;
+        int shift = static_cast<int>(bit % 64);
+        std::uint64_t value = lower_[word] >> shift;
+        if (shift + lowBits_ > 64) {
+            value |= lower_[word + 1] << (64 - shift);
+        }
+        return value & lowMask_;
+    }
+
+    void setLow(std::size_t i, std::uint64_t value) {
+        if (lowBits_ == 0) {
+            return;
+        }
+        std::size_t bit = i * static_cast<std::size_t>(lowBits_);
+        std::size_t word = bit / 64;
+        int shift = static_cast<int>(bit % 64);
+        lower_[word] |= value << shift;
+        if (shift + lowBits_ > 64) {
+            lower_[word + 1] |= value >> (64 - shift);
+        }
+    }
+
+    // Records the position of every kSelectSample-th bit among the set bits of
+    // one word, given how many came before it; returns the new count
+    static std::size_t addSamples(std::vector<std::size_t>& samples, std::uint64_t bits, std::size_t word,
+                                  std::size_t before) {
+        std::size_t count = static_cast<std::size_t>(detail::popCount64(bits));
+        for (std::size_t next = (before + kSelectSample - 1) / kSelectSample * kSelectSample; next < before + count;
+             next += kSelectSample) {
+            samples.push_back(word * 64 + static_cast<std::size_t>(detail::selectInWord(bits, static_cast<int>(next - before))));
+        }
+        return before + count;
+    }
+
+    // Position of the rank-th set bit (or clear bit) of the upper bitvector
+    template <bool Ones>
+    std::size_t select(const std::vector<std::size_t>& samples, std::size_t rank) const {
+        std::size_t bit = samples[rank / kSelectSample];
+        rank %= kSelectSample;
+        std::size_t word = bit / 64;
+        std::uint64_t bits = (Ones ? upper_[word] : ~upper_[word]) & (~std::uint64_t(0) << (bit % 64));
+        for (;;) {
+            std::size_t count = static_cast<std::size_t>(detail::popCount64(bits));
+            if (rank < count) {
+                return word * 64 + static_cast<std::size_t>(detail::selectInWord(bits, static_cast<int>(rank)));
+            }
+            rank -= count;
+            ++word;
+            bits = Ones ? upper_[word] : ~upper_[word];
+        }
+    }
+
+    std::size_t selectOne(std::size_t rank) const { return select<true>(selectOne_, rank); }
+    std::size_t selectZero(std::size_t rank) const { return select<false>(selectZero_, rank); }
+};
+
+} // namespace search
+
+#endif // ELIAS_FANO_HPP
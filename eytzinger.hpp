@@ -0,0 +1,161 @@
+#ifndef EYTZINGER_HPP
+#define EYTZINGER_HPP
+
+#include <vector>
+#include <algorithm> // For std::min
+#include "search.hpp"
+
+namespace search {
+
+/**
+ * @brief Read-only search index over a sorted array in Eytzinger (BFS) order.
+ *
+ * The keys are stored as an implicit binary tree: the root at slot 1 and the
+ * children of slot k at 2k and 2k+1. The first levels of every search touch
+ * the same few cache lines, and each step prefetches the descendants one
+ * cache line further down, so the descent overlaps its memory accesses.
+ *
+ * Results are positions in the original sorted array, as returned by
+ * search::lowerBound on that array. The mapping from tree slot back to
+ * sorted position is computed arithmetically, so no extra array is kept.
+ */
+template <typename T, typename Compare = std::less<>>
+class EytzingerIndex {
+public:
+    EytzingerIndex() = default;
+
+    /**
+     * @brief Builds the index from a sorted range.
+     *
+     * @param first, last Keys sorted by comp; the range is copied.
+     * @param comp The ordering the keys are sorted by.
+     */
+    template <typename RandomIt>
+    EytzingerIndex(RandomIt first, RandomIt last, Compare comp = {})
+        : comp_(comp), count_(static_cast<std::size_t>(last - first)) {
+        tree_.resize(count_ + 1);
+        height_ = count_ == 0 ? 0 : detail::floorLog2(count_) + 1;
+        for (std::size_t k = 1; k <= count_; ++k) {
+            tree_[k] = first[sortedPosition(k)];
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit EytzingerIndex(const Range& sorted, Compare comp = {})
+        : EytzingerIndex(std::begin(sorted), std::end(sorted), comp) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Sorted position of the first key not ordered before key (size() if none).
+    template <typename Key>
+    std::size_t lowerBound(const Key& key) const {
+        std::size_t k = 1;
+        while (k <= count_) {
+            detail::prefetchElement(tree_.data(), k * kPrefetchStride);
+            k = 2 * k + (comp_(tree_[k], key) ? 1 : 0);
+        }
+        return resultPosition(k);
+    }
+
+    /// Sorted position of the first key ordered after key (size() if none).
+    template <typename Key>
+    std::size_t upperBound(const Key& key) const {
+        std::size_t k = 1;
+        while (k <= count_) {
+            detail::prefetchElement(tree_.data(), k * kPrefetchStride);
+            k = 2 * k + (comp_(key, tree_[k]) ? 0 : 1);
+        }
+        return resultPosition(k);
+    }
+
+    /// Sorted position of a key equivalent to key, or search::npos.
+    template <typename Key>
+    std::size_t find(const Key& key) const {
+        std::size_t k = 1;
+        while (k <= count_) {
+            detail::prefetchElement(tree_.data(), k * kPrefetchStride);
+            k = 2 * k + (comp_(tree_[k], key) ? 1 : 0);
+        }
+        k = lastLeftTurn(k);
+        if (k == 0 || comp_(key, tree_[k])) {
+            return npos;
+        }
+        return sortedPosition(k);
+    }
+
+    /**
+     * @brief Lower bound for many keys at once.
+     *
+     * Descends up to kBatchGroup trees side by side, one level at a time,
+     * prefetching every query's next slot before any of them is read. The
+     * cache misses of a group then overlap instead of being paid in turn.
+     *
+     * @param results Receives lowerBound(queries[i]) at index i.
+     */
+    template <typename Key>
+    void lowerBoundBatch(const Key* queries, std::size_t count, std::size_t* results) const {
+        std::size_t fullLevels = height_ > 0 ? static_cast<std::size_t>(height_ - 1) : 0;
+        std::size_t k[kBatchGroup];
+        for (std::size_t start = 0; start < count; start += kBatchGroup) {
+            std::size_t group = std::min(kBatchGroup, count - start);
+            const Key* keys = queries + start;
+            for (std::size_t i = 0; i < group; ++i) {
+                k[i] = 1;
+            }
+            // Every descent passes through all complete levels
+            for (std::size_t level = 0; level < fullLevels; ++level) {
+                for (std::size_t i = 0; i < group; ++i) {
+                    k[i] = 2 * k[i] + (comp_(tree_[k[i]], keys[i]) ? 1 : 0);
+                    detail::prefetchElement(tree_.data(), k[i]);
+                }
+            }
+            for (std::size_t i = 0; i < group; ++i) {
+                if (k[i] <= count_) { // The partial last level
+                    k[i] = 2 * k[i] + (comp_(tree_[k[i]], keys[i]) ? 1 : 0);
+                }
+                results[start + i] = resultPosition(k[i]);
+            }
+        }
+    }
+
+    /// The key stored at tree slot k (1-based), mainly for debugging.
+    const T& slot(std::size_t k) const { return tree_[k]; }
+
+private:
+    // Descendants this many slots below k share one cache line: for 4-byte
+    // keys that is four levels ahead, and never less than the grandchildren.
+    static constexpr std::size_t kPrefetchStride = (64 / sizeof(T)) < 4 ? 4 : (64 / sizeof(T));
+
+    Compare comp_{};
+    std::size_t count_ = 0;
+    int height_ = 0; // Levels in the tree, including a partial last level
+    std::vector<T, detail::AlignedAllocator<T>> tree_; // Slot 0 unused
+
+    // Undoes the right turns taken after the last left turn of the descent,
+    // giving the slot of the answer (0 when the descent never turned left).
+    static std::size_t lastLeftTurn(std::size_t k) {
+        return k >> (detail::countTrailingZeros(~static_cast<std::uint64_t>(k)) + 1);
+    }
+
+    std::size_t resultPosition(std::size_t k) const {
+        k = lastLeftTurn(k);
+        return k == 0 ? count_ : sortedPosition(k);
+    }
+
+    // In-order rank of slot k. The rank in a perfect tree of the same height
+    // follows from k's depth and offset within its level; then subtract the
+    // last-level slots that would come before it but don't exist.
+    std::size_t sortedPosition(std::size_t k) const {
+        int depth = detail::floorLog2(k);
+        std::size_t offset = k - (std::size_t(1) << depth);
+        std::size_t perfectRank = ((2 * offset + 1) << (height_ - 1 - depth)) - 1;
+        std::size_t lastLevelPresent = count_ - ((std::size_t(1) << (height_ - 1)) - 1);
+        std::size_t lastLevelBefore = (perfectRank + 1) / 2; // Even ranks are last-level slots
+        return perfectRank - (lastLevelBefore > lastLevelPresent ? lastLevelBefore - lastLevelPresent : 0);
+    }
+};
+
+} // namespace search
+
+#endif // EYTZINGER_HPP
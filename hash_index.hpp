@@ -0,0 +1,102 @@
+#ifndef HASH_INDEX_HPP
+#define HASH_INDEX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "search.hpp"
+
+namespace search {
+
+/**
+ * @brief Static hash table from key to sorted position, for exact matches.
+ *
+ * For callers that only ask "is it there, and where", not for ranges.
+ * Built from the sorted array in one linear pass, it stores each distinct
+ * key next to the position of its first occurrence in an open-addressing
+ * table at most half full. A lookup hashes the key, goes to its home slot
+ * and probes forward; at that load almost every lookup ends in the home
+ * slot's cache line, so hits and misses alike cost about one cache miss
+ * however large the array, against log n dependent accesses for a search.
+ *
+ * Keys compare as equivalent under operator<, matching SearchIndex;
+ * hashing goes through search::detail::hashKey.
+ */
+template <typename T>
+class HashIndex {
+    static_assert(detail::kHashable<T>, "HashIndex needs keys that std::hash supports");
+
+public:
+    HashIndex() = default;
+
+    /// Indexes keys sorted in ascending order (duplicates allowed).
+    template <typename RandomIt>
+    HashIndex(RandomIt first, RandomIt last) : count_(static_cast<std::size_t>(last - first)) {
+        if (count_ == 0) {
+            return;
+        }
+        std::size_t capacity = 2;
+        while (capacity < 2 * count_) {
+            capacity *= 2;
+        }
+        shift_ = 64 - detail::floorLog2(capacity);
+        slots_.assign(capacity, Slot{T{}, kEmpty});
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (i > 0 && !(first[i - 1] < first[i])) {
+                continue; // A duplicate; its first occurrence is already in
+            }
+            std::size_t slot = homeSlot(first[i]);
+            while (slots_[slot].position != kEmpty) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            slots_[slot] = Slot{first[i], i};
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit HashIndex(const Range& sorted) : HashIndex(std::begin(sorted), std::end(sorted)) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Position of the first key equal to key, or search::npos.
+    std::size_t find(const T& key) const {
+        if (slots_.empty()) {
+            return npos;
+        }
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t slot = homeSlot(key);; slot = (slot + 1) & mask) {
+            const Slot& entry = slots_[slot];
+            if (entry.position == kEmpty) {
+                return npos;
+            }
+            if (!(entry.key < key) && !(key < entry.key)) {
+                return entry.position;
+            }
+        }
+    }
+
+    bool contains(const T& key) const { return find(key) != npos; }
+
+    std::size_t memoryBytes() const { return slots_.size() * sizeof(Slot); }
+
+private:
+    static constexpr std::size_t kEmpty = npos;
+
+    struct Slot {
+        T key;
+        std::size_t position; // kEmpty for a free slot
+    };
+
+    std::size_t count_ = 0;
+    int shift_ = 64; // 64 - log2(capacity): the hash's top bits pick the slot
+    std::vector<Slot, detail::AlignedAllocator<Slot>> slots_;
+
+    std::size_t homeSlot(const T& key) const {
+        return static_cast<std::size_t>(detail::hashKey(key) >> shift_);
+    }
+};
+
+} // namespace search
+
+#endif // HASH_INDEX_HPP
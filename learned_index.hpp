@@ -0,0 +1,218 @@
+#ifndef LEARNED_INDEX_HPP
+#define LEARNED_INDEX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include "search.hpp"
+
+namespace search {
+
+/**
+ * @brief Learned index over sorted integer keys (PGM-style piecewise-linear model).
+ *
+ * The keys are covered by linear segments, each predicting the position of
+ * any of its keys to within epsilon. A lookup evaluates the segment's line
+ * and finishes with a lower bound over the 2 * epsilon + 3 keys around the
+ * prediction (search::simd: halving, then a vectorized scan of the last
+ * few dozen keys), so data that is close to linear (timestamps,
+ * sequential IDs) needs only a handful of segments and one short search.
+ *
+ * The segments' first keys are themselves indexed the same way, recursively,
+ * until a single root segment remains. Segments are fitted greedily with a
+ * shrinking cone anchored at each segment's first key.
+ *
+ * Duplicate keys can put the answer outside the predicted window; such
+ * lookups are detected and fall back to a binary search of the remainder,
+ * so results are always exact.
+ */
+template <typename T>
+class LearnedIndex {
+    static_assert(std::is_integral_v<T>, "LearnedIndex supports integer keys");
+
+public:
+    /// Error bound of the leaf segments when none is given.
+    static constexpr std::size_t kDefaultEpsilon = 64;
+
+    LearnedIndex() = default;
+
+    /**
+     * @brief Builds the index from keys sorted in ascending order.
+     *
+     * @param first, last The sorted keys; the range is copied.
+     * @param epsilon Maximum distance between a key's predicted and actual position.
+     */
+    template <typename RandomIt>
+    LearnedIndex(RandomIt first, RandomIt last, std::size_t epsilon = kDefaultEpsilon)
+        : keys_(first, last), epsilon_(std::max<std::size_t>(epsilon, 1)) {
+        if (keys_.empty()) {
+            return;
+        }
+        levels_.push_back(fitSegments(keys_, epsilon_));
+        while (levels_.back().size() > 1) {
+            std::vector<T> firstKeys;
+            firstKeys.reserve(levels_.back().size());
+            for (const Segment& segment : levels_.back()) {
+                firstKeys.push_back(segment.key);
+            }
+            levels_.push_back(fitSegments(firstKeys, kInnerEpsilon));
+            levelKeys_.push_back(std::move(firstKeys));
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit LearnedIndex(const Range& sorted, std::size_t epsilon = kDefaultEpsilon)
+        : LearnedIndex(std::begin(sorted), std::end(sorted), epsilon) {}
+
+    std::size_t size() const { return keys_.size(); }
+    bool empty() const { return keys_.empty(); }
+
+    /// Index of the first key >= key in the sorted input (size() if none).
+    std::size_t lowerBound(T key) const {
+        if (keys_.empty()) {
+            return 0;
+        }
+        std::size_t segment = 0;
+        for (std::size_t level = levels_.size() - 1; level > 0; --level) {
+            const std::vector<T>& below = levelKeys_[level - 1];
+            std::size_t guess = predict(levels_[level], segment, key, below.size());
+            // The segment to descend into is the last one starting at or before key
+            std::size_t next = windowSearch(below, guess, kInnerEpsilon, key, std::less_equal<>());
+            segment = next > 0 ? next - 1 : 0;
+        }
+        std::size_t guess = predict(levels_[0], segment, key, keys_.size());
+        return windowSearch(keys_, guess, epsilon_, key, std::less<>());
+    }
+
+    /// Index of the first key > key in the sorted input (size() if none).
+    std::size_t upperBound(T key) const {
+        return key == std::numeric_limits<T>::max() ? keys_.size() : lowerBound(key + 1);
+    }
+
+    /// Index of key in the sorted input, or search::npos.
+    std::size_t find(T key) const {
+        std::size_t position = lowerBound(key);
+        return (position < keys_.size() && keys_[position] == key) ? position : npos;
+    }
+
+    std::size_t epsilon() const { return epsilon_; }
+
+    /// Segments in the leaf level, the one that indexes the keys.
+    std::size_t segmentCount() const { return levels_.empty() ? 0 : levels_[0].size(); }
+
+    /// Levels of segments, including the root.
+    std::size_t height() const { return levels_.size(); }
+
+    /// Bytes used by the model alone (segments and inner-level keys).
+    std::size_t modelBytes() const {
+        std::size_t bytes = 0;
+        for (const auto& level : levels_) {
+            bytes += level.size() * sizeof(Segment);
+        }
+        for (const auto& keys : levelKeys_) {
+            bytes += keys.size() * sizeof(T);
+        }
+        return bytes;
+    }
+
+    /// Bytes used by the model plus the copy of the keys.
+    std::size_t memoryBytes() const { return modelBytes() + keys_.size() * sizeof(T); }
+
+private:
+    // Error bound of the segments that index other segments
+    static constexpr std::size_t kInnerEpsilon = 8;
+
+    using Unsigned = std::make_unsigned_t<T>;
+
+    // Line through (key, position) with the given slope
+    struct Segment {
+        T key;
+        std::size_t position;
+        double slope;
+    };
+
+    std::vector<T> keys_;
+    std::size_t epsilon_ = kDefaultEpsilon;
+    std::vector<std::vector<Segment>> levels_;  // Leaf segments at [0], root last
+    std::vector<std::vector<T>> levelKeys_;     // First keys of levels_[i], indexed by levels_[i + 1]
+
+    // Distance from `from` up to `to` as a double, exact for any from <= to
+    static double keyDistance(T from, T to) {
+        return static_cast<double>(static_cast<Unsigned>(static_cast<Unsigned>(to) - static_cast<Unsigned>(from)));
+    }
+
+    // Greedy shrinking cone: a segment grows while some slope through its
+    // first point keeps every later point within epsilon. Only the first
+    // occurrence of a repeated key becomes a point.
+    static std::vector<Segment> fitSegments(const std::vector<T>& keys, std::size_t epsilon) {
+        std::vector<Segment> segments;
+        const double error = static_cast<double>(epsilon);
+        double lowSlope = 0;
+        double highSlope = std::numeric_limits<double>::infinity();
+        segments.push_back({keys[0], 0, 0});
+        for (std::size_t i = 1; i < keys.size(); ++i) {
+            if (keys[i] == keys[i - 1]) {
+                continue;
+            }
+            Segment& current = segments.back();
+            double dx = keyDistance(current.key, keys[i]);
+            double dy = static_cast<double>(i - current.position);
+            double low = std::max(lowSlope, (dy - error) / dx);
+            double high = std::min(highSlope, (dy + error) / dx);
+            if (low <= high) {
+                lowSlope = low;
+                highSlope = high;
+                continue;
+            }
+            current.slope = finishSlope(lowSlope, highSlope);
+            segments.push_back({keys[i], i, 0});
+            lowSlope = 0;
+            highSlope = std::numeric_limits<double>::infinity();
+        }
+        segments.back().slope = finishSlope(lowSlope, highSlope);
+        return segments;
+    }
+
+    static double finishSlope(double low, double high) {
+        return high == std::numeric_limits<double>::infinity() ? low : (low + high) / 2;
+    }
+
+    // Predicted position of key, clamped to the range the segment covers
+    static std::size_t predict(const std::vector<Segment>& segments, std::size_t index, T key, std::size_t n) {
+        const Segment& segment = segments[index];
+        if (key <= segment.key) {
+            return segment.position;
+        }
+        std::size_t end = index + 1 < segments.size() ? segments[index + 1].position : n;
+        double offset = segment.slope * keyDistance(segment.key, key);
+        if (offset >= static_cast<double>(end - segment.position)) {
+            return end;
+        }
+        return segment.position + static_cast<std::size_t>(offset);
+    }
+
+    // First i with !comp(keys[i], key), searched within radius of guess.
+    // When the answer lies outside the window, the rest is searched in full.
+    template <typename Compare>
+    static std::size_t windowSearch(const std::vector<T>& keys, std::size_t guess, std::size_t radius, T key,
+                                    Compare comp) {
+        const std::size_t n = keys.size();
+        std::size_t low = guess > radius + 1 ? guess - radius - 1 : 0;
+        std::size_t high = std::min(n, guess + radius + 2);
+        auto first = keys.begin();
+        if (low > 0 && !comp(keys[low - 1], key)) {
+            return static_cast<std::size_t>(search::lowerBound(branchless, first, first + low, key, comp) - first);
+        }
+        std::size_t position = static_cast<std::size_t>(
+            search::lowerBound(simd, first + low, first + high, key, comp) - first);
+        if (position == high && high < n && comp(keys[high], key)) {
+            position = static_cast<std::size_t>(search::lowerBound(branchless, first + high, keys.end(), key, comp) - first);
+        }
+        return position;
+    }
+};
+
+} // namespace search
+
+#endif // LEARNED_INDEX_HPP
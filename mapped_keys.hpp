@@ -0,0 +1,325 @@
+#ifndef MAPPED_KEYS_HPP
+#define MAPPED_KEYS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "search.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SEARCH_HAS_MMAP 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SEARCH_HAS_MMAP 0
+#endif
+
+#if SEARCH_HAS_MMAP
+
+namespace search {
+
+/**
+ * @brief Layout of a sorted key file, at offset 0.
+ *
+ * The keys start on a page boundary, so the keys of one page-sized block
+ * span at most two pages. After them comes the sparse index: the first key
+ * of every block. Fields are in native byte order; a file is read on the
+ * kind of machine that wrote it.
+ */
+struct KeyFileHeader {
+    char magic[8];
+    std::uint32_t keySize;
+    std::uint32_t pageSize;
+    std::uint64_t count;
+    std::uint64_t keysOffset;
+    std::uint64_t indexOffset;
+    std::uint64_t blockKeys; // Keys per sparse-index entry
+};
+
+inline constexpr char kKeyFileMagic[8] = {'S', 'R', 'C', 'H', 'K', 'E', 'Y', '1'};
+
+/**
+ * @brief Read-only view of a sorted fixed-width key file through mmap.
+ *
+ * Only the sparse index, one key per page of data, is copied into memory.
+ * A lookup searches it to pick a block and then searches that block in the
+ * mapping, so it touches at most two data pages and never the pages a
+ * binary search over the whole file would walk through on its way.
+ *
+ * The mapping is advised MADV_RANDOM, so the kernel doesn't read ahead
+ * around each page. lowerBoundBatch resolves queries in file order and
+ * asks for the next pages with MADV_WILLNEED ahead of use.
+ *
+ * T must be trivially copyable and ordered by operator<.
+ */
+template <typename T>
+class MappedKeyFile {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedKeyFile keys are stored as raw bytes");
+
+public:
+    /**
+     * @brief Writes keys, sorted in ascending order, as a key file.
+     *
+     * @throws std::system_error if the file cannot be written.
+     */
+    static void write(const std::string& path, const T* keys, std::size_t count) {
+        const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        KeyFileHeader header{};
+        std::memcpy(header.magic, kKeyFileMagic, sizeof(header.magic));
+        header.keySize = sizeof(T);
+        header.pageSize = static_cast<std::uint32_t>(pageSize);
+        header.count = count;
+        header.keysOffset = roundUp(sizeof(KeyFileHeader), pageSize);
+        header.blockKeys = std::max<std::size_t>(pageSize / sizeof(T), 1);
+        header.indexOffset = roundUp(header.keysOffset + count * sizeof(T), 64);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        auto padTo = [&](std::uint64_t offset) {
+            static const char zeros[64] = {};
+            for (auto at = static_cast<std::uint64_t>(out.tellp()); at < offset;) {
+                std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(offset - at, sizeof(zeros)));
+                out.write(zeros, static_cast<std::streamsize>(chunk));
+                at += chunk;
+            }
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        padTo(header.keysOffset);
+        out.write(reinterpret_cast<const char*>(keys), static_cast<std::streamsize>(count * sizeof(T)));
+        padTo(header.indexOffset);
+        for (std::size_t i = 0; i < count; i += header.blockKeys) {
+            out.write(reinterpret_cast<const char*>(&keys[i]), sizeof(T));
+        }
+        out.flush();
+        if (!out) {
+            throw std::system_error(errno, std::generic_category(), "cannot write key file " + path);
+        }
+    }
+
+    static void write(const std::string& path, const std::vector<T>& keys) {
+        write(path, keys.data(), keys.size());
+    }
+
+    MappedKeyFile() = default;
+
+    /**
+     * @brief Maps a key file written by write().
+     *
+     * @throws std::system_error if it cannot be opened or mapped.
+     * @throws std::runtime_error if it is not a key file of T.
+     */
+    explicit MappedKeyFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "cannot open key file " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(KeyFileHeader))) {
+            ::close(fd);
+            throw std::runtime_error("not a key file: " + path);
+        }
+        mappedBytes_ = static_cast<std::size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, mappedBytes_, PROT_READ, MAP_SHARED, fd, 0);
+        int mapErrno = errno;
+        ::close(fd); // The mapping keeps the file open
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(mapErrno, std::generic_category(), "cannot map key file " + path);
+        }
+        mapping_ = static_cast<const char*>(mapping);
+
+        std::memcpy(&header_, mapping_, sizeof(header_));
+        if (std::memcmp(header_.magic, kKeyFileMagic, sizeof(header_.magic)) != 0 || header_.keySize != sizeof(T) ||
+            header_.blockKeys == 0 || header_.keysOffset + header_.count * sizeof(T) > header_.indexOffset ||
+            header_.indexOffset + indexEntries(header_) * sizeof(T) > mappedBytes_) {
+            unmap();
+            throw std::runtime_error("not a key file of " + std::to_string(sizeof(T)) + "-byte keys: " + path);
+        }
+        keys_ = reinterpret_cast<const T*>(mapping_ + header_.keysOffset);
+        ::madvise(const_cast<char*>(mapping_), mappedBytes_, MADV_RANDOM);
+
+        const T* index = reinterpret_cast<const T*>(mapping_ + header_.indexOffset);
+        index_.assign(index, index + indexEntries(header_));
+    }
+
+    MappedKeyFile(MappedKeyFile&& other) noexcept { *this = std::move(other); }
+
+    MappedKeyFile& operator=(MappedKeyFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mappedBytes_ = std::exchange(other.mappedBytes_, 0);
+            header_ = other.header_;
+            keys_ = std::exchange(other.keys_, nullptr);
+            index_ = std::move(other.index_);
+        }
+        return *this;
+    }
+
+    MappedKeyFile(const MappedKeyFile&) = delete;
+    MappedKeyFile& operator=(const MappedKeyFile&) = delete;
+
+    ~MappedKeyFile() { unmap(); }
+
+    std::size_t size() const { return keys_ ? static_cast<std::size_t>(header_.count) : 0; }
+    bool empty() const { return size() == 0; }
+
+    /// The keys in the mapping, for direct searches; reading them may fault pages in.
+    const T* data() const { return keys_; }
+    const T* begin() const { return keys_; }
+    const T* end() const { return keys_ + size(); }
+
+    /// Keys covered by one sparse-index entry (one page of keys).
+    std::size_t blockKeys() const { return static_cast<std::size_t>(header_.blockKeys); }
+
+    /// Bytes of the in-memory sparse index.
+    std::size_t indexBytes() const { return index_.size() * sizeof(T); }
+
+    /// Index of the first key not less than key (size() if none).
+    std::size_t lowerBound(const T& key) const {
+        if (index_.empty()) {
+            return 0;
+        }
+        return searchBlock(blockOf(key), key);
+    }
+
+    /// Index of key in the file, or search::npos.
+    std::size_t find(const T& key) const {
+        std::size_t position = lowerBound(key);
+        return (position < size() && !(key < keys_[position])) ? position : npos;
+    }
+
+    /**
+     * @brief Lower bound for many keys, resolved in page order.
+     *
+     * Queries are grouped by the block the sparse index sends them to and
+     * processed in ascending block order, so each data page is touched once
+     * per batch and the pages are visited front to back. Pages are requested
+     * with MADV_WILLNEED up to 2 * kPrefetchBlocks distinct blocks ahead.
+     *
+     * @param results Receives lowerBound(queries[i]) at index i.
+     */
+    void lowerBoundBatch(const T* queries, std::size_t count, std::size_t* results) const {
+        if (index_.empty()) {
+            std::fill(results, results + count, std::size_t(0));
+            return;
+        }
+        std::vector<std::pair<std::size_t, std::size_t>> order(count); // (block, query)
+        for (std::size_t i = 0; i < count; ++i) {
+            order[i] = {blockOf(queries[i]), i};
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<std::size_t> blocks; // Distinct blocks in visiting order
+        for (std::size_t j = 0; j < count; ++j) {
+            if (j == 0 || order[j].first != order[j - 1].first) {
+                blocks.push_back(order[j].first);
+            }
+        }
+        // Blocks are advised kPrefetchBlocks at a time, one group ahead; a group
+        // whose blocks lie close together takes a single madvise call
+        auto adviseGroup = [&](std::size_t group) {
+            std::size_t begin = group * kPrefetchBlocks;
+            std::size_t end = std::min(blocks.size(), begin + kPrefetchBlocks);
+            if (begin >= end) {
+                return;
+            }
+            if (blocks[end - 1] - blocks[begin] < 4 * kPrefetchBlocks) {
+                willNeed(blocks[begin], blocks[end - 1]);
+            } else {
+                for (std::size_t d = begin; d < end; ++d) {
+                    willNeed(blocks[d], blocks[d]);
+                }
+            }
+        };
+        adviseGroup(0);
+        adviseGroup(1);
+        std::size_t current = 0; // Position of order[j].first in blocks
+        for (std::size_t j = 0; j < count; ++j) {
+            if (j > 0 && order[j].first != order[j - 1].first) {
+                ++current;
+                if (current % kPrefetchBlocks == 0) {
+                    adviseGroup(current / kPrefetchBlocks + 1);
+                }
+            }
+            results[order[j].second] = searchBlock(order[j].first, queries[order[j].second]);
+        }
+    }
+
+    std::vector<std::size_t> lowerBoundBatch(const std::vector<T>& queries) const {
+        std::vector<std::size_t> results(queries.size());
+        lowerBoundBatch(queries.data(), queries.size(), results.data());
+        return results;
+    }
+
+    /// Releases the mapped pages from this process; later reads fault them back in.
+    void evict() const {
+        if (mapping_) {
+            ::madvise(const_cast<char*>(mapping_), mappedBytes_, MADV_DONTNEED);
+        }
+    }
+
+private:
+    // Distinct blocks requested ahead of the one being searched in lowerBoundBatch
+    static constexpr std::size_t kPrefetchBlocks = 16;
+
+    const char* mapping_ = nullptr;
+    std::size_t mappedBytes_ = 0;
+    KeyFileHeader header_{};
+    const T* keys_ = nullptr;
+    std::vector<T> index_; // First key of each block
+
+    static std::size_t roundUp(std::size_t value, std::size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    static std::size_t indexEntries(const KeyFileHeader& header) {
+        return static_cast<std::size_t>((header.count + header.blockKeys - 1) / header.blockKeys);
+    }
+
+    // The block holding key's lower bound: the last one whose first key is
+    // below key (block 0 if none). Every key of later blocks is >= key, so
+    // the answer is in this block or is the first key of the next one.
+    std::size_t blockOf(const T& key) const {
+        std::size_t next = search::lowerBound(branchless, index_, key);
+        return next > 0 ? next - 1 : 0;
+    }
+
+    // The answer lies in the block or is the first key after it
+    std::size_t searchBlock(std::size_t block, const T& key) const {
+        std::size_t begin = block * blockKeys();
+        std::size_t end = std::min(size(), begin + blockKeys());
+        return static_cast<std::size_t>(search::lowerBound(branchless, keys_ + begin, keys_ + end, key) - keys_);
+    }
+
+    // Asks the kernel to start reading blocks first..last
+    void willNeed(std::size_t first, std::size_t last) const {
+        std::size_t pageSize = header_.pageSize;
+        std::size_t begin = header_.keysOffset + first * blockKeys() * sizeof(T);
+        std::size_t end = std::min<std::size_t>(header_.keysOffset + (last + 1) * blockKeys() * sizeof(T),
+                                                header_.keysOffset + size() * sizeof(T));
+        std::size_t pageBegin = begin / pageSize * pageSize;
+        ::madvise(const_cast<char*>(mapping_ + pageBegin), end - pageBegin, MADV_WILLNEED);
+    }
+
+    void unmap() {
+        if (mapping_) {
+            ::munmap(const_cast<char*>(mapping_), mappedBytes_);
+            mapping_ = nullptr;
+            keys_ = nullptr;
+        }
+    }
+};
+
+} // namespace search
+
+#endif // SEARCH_HAS_MMAP
+
+#endif // MAPPED_KEYS_HPP
@@ -0,0 +1,304 @@
+#ifndef PACKED_KEYS_HPP
+#define PACKED_KEYS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include "search.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace search {
+
+/**
+ * @brief Sorted integer keys compressed as frame-of-reference blocks.
+ *
+ * Keys are cut into blocks of 128. Each block keeps its first key (the
+ * block base) in an uncompressed skip array and stores every key as its
+ * offset from the base, bit-packed with just enough bits for the largest
+ * offset. IDs with small gaps need a few bits per key instead of 32 or 64.
+ *
+ * The packing is "vertical" over four 32-bit lanes: key i of a block goes
+ * to lane i % 4, and each lane is a stream of width-bit values whose 32-bit
+ * words are interleaved with the other lanes'. With SSE2 a block then
+ * unpacks four keys per shift-and-mask, without any shuffles; offsets
+ * wider than 32 bits (int64 keys with large gaps) unpack with scalar code.
+ *
+ * A lookup searches the skip array with the branchless kernel, unpacks the
+ * one block it lands in and searches that block's 128 offsets.
+ */
+template <typename T>
+class PackedSortedArray {
+    static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "PackedSortedArray supports 32- and 64-bit integer keys");
+
+public:
+    static constexpr std::size_t kBlockKeys = 128;
+
+    PackedSortedArray() = default;
+
+    /// Packs keys sorted in ascending order.
+    template <typename RandomIt>
+    PackedSortedArray(RandomIt first, RandomIt last) : count_(static_cast<std::size_t>(last - first)) {
+        std::size_t blocks = (count_ + kBlockKeys - 1) / kBlockKeys;
+        heads_.reserve(blocks);
+        blockWords_.reserve(blocks + 1);
+        blockWords_.push_back(0);
+        Offset offsets[kBlockKeys];
+        for (std::size_t start = 0; start < count_; start += kBlockKeys) {
+            std::size_t keys = std::min(kBlockKeys, count_ - start);
+            T base = first[start];
+            heads_.push_back(base);
+            for (std::size_t i = 0; i < kBlockKeys; ++i) {
+                // A short last block repeats its last key
+                offsets[i] = static_cast<Offset>(first[start + std::min(i, keys - 1)]) - static_cast<Offset>(base);
+            }
+            pack(offsets, bitWidth(offsets[kBlockKeys - 1]));
+            blockWords_.push_back(words_.size());
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit PackedSortedArray(const Range& sorted) : PackedSortedArray(std::begin(sorted), std::end(sorted)) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Bytes used by packed words, skip array and block offsets.
+    std::size_t memoryBytes() const {
+        return words_.size() * sizeof(std::uint32_t) + heads_.size() * sizeof(T) +
+               blockWords_.size() * sizeof(std::size_t);
+    }
+
+    /// The key at sorted position i.
+    T operator[](std::size_t i) const {
+        std::size_t block = i / kBlockKeys;
+        return fromOffset(block, extract(block, i % kBlockKeys));
+    }
+
+    /// Index of the first key >= key (size() if none).
+    std::size_t lowerBound(T key) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        // Blocks after the last head below key hold only keys >= key
+        std::size_t next = search::lowerBound(branchless, heads_, key);
+        if (next == 0) {
+            return 0;
+        }
+        std::size_t block = next - 1;
+        Offset target = static_cast<Offset>(key) - static_cast<Offset>(heads_[block]);
+        std::size_t keys = std::min(kBlockKeys, count_ - block * kBlockKeys);
+        std::size_t position;
+        int width = blockWidth(block);
+        if (width <= 32) {
+            if ((static_cast<std::uint64_t>(target) >> width) != 0) {
+                return block * kBlockKeys + keys; // Beyond every offset the block can hold
+            }
+            alignas(16) std::uint32_t offsets[kBlockKeys];
+            unpack32(block, offsets);
+            position = static_cast<std::size_t>(
+                search::lowerBound(branchless, offsets, offsets + keys, static_cast<std::uint32_t>(target)) - offsets);
+        } else {
+            Offset offsets[kBlockKeys];
+            unpackScalar(block, offsets);
+            position = static_cast<std::size_t>(search::lowerBound(branchless, offsets, offsets + keys, target) - offsets);
+        }
+        return block * kBlockKeys + position;
+    }
+
+    /// Index of the first key > key (size() if none).
+    std::size_t upperBound(T key) const {
+        return key == std::numeric_limits<T>::max() ? count_ : lowerBound(key + 1);
+    }
+
+    /// Index of key, or search::npos.
+    std::size_t find(T key) const {
+        std::size_t position = lowerBound(key);
+        return (position < count_ && (*this)[position] == key) ? position : npos;
+    }
+
+    bool contains(T key) const { return find(key) != npos; }
+
+    /// Forward iterator that unpacks one block at a time.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        const T& operator*() const { return keys_[position_ % kBlockKeys]; }
+        const T* operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            if (++position_ % kBlockKeys == 0) {
+                load();
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.position_ == b.position_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) { return !(a == b); }
+
+    private:
+        friend class PackedSortedArray;
+
+        const PackedSortedArray* array_ = nullptr;
+        std::size_t position_ = 0;
+        T keys_[kBlockKeys];
+
+        const_iterator(const PackedSortedArray* array, std::size_t position) : array_(array), position_(position) {
+            load();
+        }
+
+        void load() {
+            if (position_ < array_->count_) {
+                array_->decodeBlock(position_ / kBlockKeys, keys_);
+            }
+        }
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count_); }
+
+    /// Unpacks every key into out, which must hold size() keys.
+    void decode(T* out) const {
+        T keys[kBlockKeys];
+        for (std::size_t block = 0; block < heads_.size(); ++block) {
+            decodeBlock(block, keys);
+            std::size_t start = block * kBlockKeys;
+            std::copy(keys, keys + std::min(kBlockKeys, count_ - start), out + start);
+        }
+    }
+
+private:
+    using Offset = std::make_unsigned_t<T>;
+    static constexpr std::size_t kLanes = 4;
+    static constexpr std::size_t kLaneKeys = kBlockKeys / kLanes;
+
+    std::size_t count_ = 0;
+    std::vector<T> heads_;                 // First key of each block
+    std::vector<std::size_t> blockWords_;  // Start of each block in words_, plus the end
+    std::vector<std::uint32_t> words_;
+
+    static int bitWidth(Offset value) {
+        return value == 0 ? 0 : detail::floorLog2(static_cast<std::uint64_t>(value)) + 1;
+    }
+
+    // Each lane holds kLaneKeys values of width bits: width words per lane
+    int blockWidth(std::size_t block) const {
+        return static_cast<int>((blockWords_[block + 1] - blockWords_[block]) / kLanes);
+    }
+
+    T fromOffset(std::size_t block, Offset offset) const {
+        return static_cast<T>(static_cast<Offset>(heads_[block]) + offset);
+    }
+
+    void pack(const Offset* offsets, int width) {
+        std::size_t first = words_.size();
+        words_.resize(first + kLanes * static_cast<std::size_t>(width), 0);
+        std::uint32_t* words = words_.data() + first;
+        for (std::size_t i = 0; i < kBlockKeys; ++i) {
+            std::size_t lane = i % kLanes;
+            std::size_t bit = (i / kLanes) * static_cast<std::size_t>(width);
+            for (int done = 0; done < width;) {
+                std::size_t word = (bit + done) / 32;
+                int shift = static_cast<int>((bit + done) % 32);
+                int take = std::min(width - done, 32 - shift);
+                words[word * kLanes + lane] |= static_cast<std::uint32_t>(offsets[i] >> done) << shift;
+                done += take;
+            }
+        }
+    }
+
+    // Offset k of a block, read straight from the packed words
+    Offset extract(std::size_t block, std::size_t k) const {
+        int width = blockWidth(block);
+        const std::uint32_t* words = words_.data() + blockWords_[block];
+        std::size_t lane = k % kLanes;
+        std::size_t bit = (k / kLanes) * static_cast<std::size_t>(width);
+        std::uint64_t value = 0;
+        for (int done = 0; done < width;) {
+            std::size_t word = (bit + done) / 32;
+            int shift = static_cast<int>((bit + done) % 32);
+            value |= static_cast<std::uint64_t>(words[word * kLanes + lane] >> shift) << done;
+            done += 32 - shift;
+        }
+        return static_cast<Offset>(width == 64 ? value : value & ((std::uint64_t(1) << width) - 1));
+    }
+
+    void unpackScalar(std::size_t block, Offset* out) const {
+        for (std::size_t k = 0; k < kBlockKeys; ++k) {
+            out[k] = extract(block, k);
+        }
+    }
+
+    // Unpacks a block of width <= 32, four offsets per step with SSE2
+    void unpack32(std::size_t block, std::uint32_t* out) const {
+        int width = blockWidth(block);
+        if (width == 0) {
+            std::fill(out, out + kBlockKeys, 0u);
+            return;
+        }
+#if defined(__SSE2__)
+        const __m128i* in = reinterpret_cast<const __m128i*>(words_.data() + blockWords_[block]);
+        const __m128i mask = _mm_set1_epi32(width == 32 ? -1 : static_cast<int>((1u << width) - 1));
+        __m128i current = _mm_loadu_si128(in);
+        int word = 0;
+        int used = 0; // Bits of current already consumed
+        for (std::size_t j = 0; j < kLaneKeys; ++j) {
+            __m128i value = _mm_srl_epi32(current, _mm_cvtsi32_si128(used));
+            used += width;
+            if (used >= 32) {
+                used -= 32;
+                if (++word < width) {
+                    current = _mm_loadu_si128(in + word);
+                    if (used > 0) {
+                        value = _mm_or_si128(value, _mm_sll_epi32(current, _mm_cvtsi32_si128(width - used)));
+                    }
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j * kLanes), _mm_and_si128(value, mask));
+        }
+#else
+        for (std::size_t k = 0; k < kBlockKeys; ++k) {
+            out[k] = static_cast<std::uint32_t>(extract(block, k));
+        }
+#endif
+    }
+
+    void decodeBlock(std::size_t block, T* out) const {
+        if (blockWidth(block) <= 32) {
+            alignas(16) std::uint32_t offsets[kBlockKeys];
+            unpack32(block, offsets);
+            for (std::size_t k = 0; k < kBlockKeys; ++k) {
+                out[k] = fromOffset(block, offsets[k]);
+            }
+        } else {
+            Offset offsets[kBlockKeys];
+            unpackScalar(block, offsets);
+            for (std::size_t k = 0; k < kBlockKeys; ++k) {
+                out[k] = fromOffset(block, offsets[k]);
+            }
+        }
+    }
+};
+
+} // namespace search
+
+#endif // PACKED_KEYS_HPP
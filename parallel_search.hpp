@@ -0,0 +1,93 @@
+#ifndef PARALLEL_SEARCH_HPP
+#define PARALLEL_SEARCH_HPP
+
+#include <algorithm>
+#include "batch_search.hpp"
+#include "thread_pool.hpp"
+
+namespace search {
+
+namespace detail {
+
+// Splits [0, count) into chunks of about chunkSize results whose boundaries
+// (except the first and last) fall on 64-byte lines of the results array,
+// so no two threads ever write to the same cache line.
+class ResultChunks {
+public:
+    ResultChunks(const std::size_t* results, std::size_t count, std::size_t chunkSize) : count_(count) {
+        constexpr std::size_t perLine = 64 / sizeof(std::size_t);
+        chunk_ = std::max(perLine, (chunkSize + perLine - 1) / perLine * perLine);
+        std::size_t misalignment = reinterpret_cast<std::uintptr_t>(results) % 64 / sizeof(std::size_t);
+        skew_ = (perLine - misalignment) % perLine;
+    }
+
+    std::size_t size() const {
+        if (count_ == 0) {
+            return 0;
+        }
+        return count_ <= skew_ ? 1 : (count_ - skew_ + chunk_ - 1) / chunk_;
+    }
+    std::size_t begin(std::size_t chunk) const { return chunk == 0 ? 0 : std::min(count_, skew_ + chunk * chunk_); }
+    std::size_t end(std::size_t chunk) const { return std::min(count_, skew_ + (chunk + 1) * chunk_); }
+
+private:
+    std::size_t count_;
+    std::size_t chunk_;
+    std::size_t skew_; // Results before the first cache-line boundary
+};
+
+} // namespace detail
+
+/// Smallest number of queries handed to one task.
+inline constexpr std::size_t kMinParallelChunk = 4096;
+
+/**
+ * @brief Batch lower bound split across a thread pool.
+ *
+ * The queries are cut into chunks (about four per thread, for load balance)
+ * and each chunk is resolved with the index's own batch kernel, so the
+ * fastest single-core kernel (STree, EytzingerIndex, ...) is what runs on
+ * every core. Chunk boundaries are cache-line aligned in results, so
+ * threads never share an output line.
+ *
+ * @param index Any index accepted by search::lowerBoundBatch.
+ * @param results Receives the lower bound of queries[i] at index i.
+ */
+template <typename Index, typename Key>
+void parallelLowerBoundBatch(ThreadPool& pool, const Index& index, const Key* queries, std::size_t count,
+                             std::size_t* results) {
+    std::size_t chunkSize = std::max(kMinParallelChunk, count / (4 * pool.size()) + 1);
+    detail::ResultChunks chunks(results, count, chunkSize);
+    pool.parallelFor(chunks.size(), [&](std::size_t chunk) {
+        std::size_t begin = chunks.begin(chunk);
+        std::size_t end = chunks.end(chunk);
+        if (begin < end) {
+            search::lowerBoundBatch(index, queries + begin, end - begin, results + begin);
+        }
+    });
+}
+
+/**
+ * @brief Parallel batch lower bound directly on a sorted array.
+ *
+ * Same chunking as the index overload; each chunk uses
+ * lowerBoundBatch(policy, ...) on the shared array.
+ */
+template <typename Policy, typename RandomIt, typename Key, typename Compare = std::less<>,
+          std::enable_if_t<detail::IsPolicy<Policy>::value, int> = 0>
+void parallelLowerBoundBatch(ThreadPool& pool, Policy policy, RandomIt first, RandomIt last, const Key* queries,
+                             std::size_t count, std::size_t* results, Compare comp = {}) {
+    std::size_t chunkSize = std::max(kMinParallelChunk, count / (4 * pool.size()) + 1);
+    detail::ResultChunks chunks(results, count, chunkSize);
+    pool.parallelFor(chunks.size(), [&](std::size_t chunk) {
+        std::size_t begin = chunks.begin(chunk);
+        std::size_t end = chunks.end(chunk);
+        if (begin < end) {
+            search::lowerBoundBatch(policy, first, last, queries + begin, end - begin, results + begin, comp);
+        }
+    });
+}
+
+} // namespace search
+
+#endif // PARALLEL_SEARCH_HPP
@@ -6,24 +6,191 @@
 #include <memory> // For smart pointers (optional but good practice)
 #include <algorithm> // For std::transform
 #include <cctype> // For ::tolower
+#include <set>
+#include <atomic> // Shared between the game loop and signal handlers
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio> // For std::rename
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <exception>
+#include <random>
+#include <charconv> // For std::to_chars
+#include <string_view>
+#include <type_traits>
+
+// The sampling profiler relies on SIGPROF, a CPU-time sample source and
+// glibc's backtrace(), so it is only compiled in on platforms that provide them.
+#if defined(__linux__) || defined(__APPLE__)
+#include <csignal>
+#include <ctime>
+#include <sys/time.h>
+#include <execinfo.h>
+#include <cxxabi.h> // For abi::__cxa_demangle
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#define TEXTADV_HAS_PROFILER 1
+#else
+#define TEXTADV_HAS_PROFILER 0
+#endif
 
 // Forward declarations
 class Room;
 class Player;
 
+//-----------------------------------------------------------------------------
+// Memory Accounting Definitions
+//-----------------------------------------------------------------------------
+// Every container that matters for memory use allocates through a
+// TrackedAllocator, which charges the exact bytes it requests to a subsystem
+// and optionally to an owner such as a single room. "admin memory" reports them.
+enum class MemoryTag : unsigned char {
+    Rooms, Exits, Items, Strings, Sessions, Caches, Journal, Other, Count
+};
+
+// Running totals for one subsystem or one owner. An owner account can roll up
+// into a parent, e.g. an item into the room that currently holds it.
+struct MemoryAccount {
+    std::atomic<long long> bytes{0};
+    std::atomic<long long> allocations{0};
+    MemoryAccount* parent = nullptr; // Only changed through reparent()
+
+    void charge(std::size_t size) { adjust(static_cast<long long>(size), 1); }
+
+    void release(std::size_t size) { adjust(-static_cast<long long>(size), -1); }
+
+    // Moves this account's totals from its current parent to newParent. Nothing
+    // may charge or release this account from another thread meanwhile.
+    void reparent(MemoryAccount* newParent) {
+        if (newParent == parent) {
+            return;
+        }
+        long long heldBytes = bytes.load(std::memory_order_relaxed);
+        long long heldAllocations = allocations.load(std::memory_order_relaxed);
+        if (parent) {
+            parent->adjust(-heldBytes, -heldAllocations);
+        }
+        parent = newParent;
+        if (parent) {
+            parent->adjust(heldBytes, heldAllocations);
+        }
+    }
+
+private:
+    void adjust(long long byteDelta, long long allocationDelta) {
+        for (MemoryAccount* account = this; account; account = account->parent) {
+            account->bytes.fetch_add(byteDelta, std::memory_order_relaxed);
+            account->allocations.fetch_add(allocationDelta, std::memory_order_relaxed);
+        }
+    }
+};
+
+class MemoryStats {
+public:
+    static constexpr std::size_t kTagCount = static_cast<std::size_t>(MemoryTag::Count);
+
+    static MemoryAccount& subsystem(MemoryTag tag) {
+        static MemoryAccount accounts[kTagCount];
+        return accounts[static_cast<std::size_t>(tag)];
+    }
+
+    static const char* name(MemoryTag tag) {
+        static const char* const names[kTagCount] = {
+            "rooms", "exits", "items", "strings", "sessions", "caches", "journal", "other"
+        };
+        return names[static_cast<std::size_t>(tag)];
+    }
+};
+
+// Standard allocator that charges a subsystem and, if given, an owner account.
+// DefaultTag is used when a container default-constructs its allocator, which
+// lets string types be tagged without passing an allocator everywhere.
+template <typename T, MemoryTag DefaultTag = MemoryTag::Other>
+class TrackedAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind { using other = TrackedAllocator<U, DefaultTag>; };
+
+    MemoryTag tag = DefaultTag;
+    MemoryAccount* owner = nullptr; // Must outlive every allocation made with it
+
+    TrackedAllocator() noexcept = default;
+    explicit TrackedAllocator(MemoryTag t, MemoryAccount* o = nullptr) noexcept : tag(t), owner(o) {}
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U, DefaultTag>& other) noexcept : tag(other.tag), owner(other.owner) {}
+
+    T* allocate(std::size_t n) {
+        T* memory = std::allocator<T>().allocate(n);
+        MemoryStats::subsystem(tag).charge(n * sizeof(T));
+        if (owner) {
+            owner->charge(n * sizeof(T));
+        }
+        return memory;
+    }
+
+    void deallocate(T* memory, std::size_t n) noexcept {
+        MemoryStats::subsystem(tag).release(n * sizeof(T));
+        if (owner) {
+            owner->release(n * sizeof(T));
+        }
+        std::allocator<T>().deallocate(memory, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U, DefaultTag>& other) const noexcept {
+        return tag == other.tag && owner == other.owner;
+    }
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U, DefaultTag>& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+// Text owned by world objects (names, descriptions)
+using TrackedString = std::basic_string<char, std::char_traits<char>, TrackedAllocator<char, MemoryTag::Strings>>;
+
+inline std::string toStdString(const TrackedString& text) {
+    return std::string(text.begin(), text.end());
+}
+
 //-----------------------------------------------------------------------------
 // Item Class Definition
 //-----------------------------------------------------------------------------
 class Item {
 public:
-    std::string name;
-    std::string description;
+    // Bytes of this item's block (charged by makeItem) and its text; rolls up
+    // into the room holding it
+    MemoryAccount memory;
+    TrackedString name;
+    TrackedString description;
     bool takeable; // Can the player pick this item up?
 
-    Item(std::string n, std::string desc, bool take = true)
-        : name(n), description(desc), takeable(take) {}
+    Item(const std::string& n, const std::string& desc, bool take = true)
+        : name(n.begin(), n.end(), TrackedString::allocator_type(MemoryTag::Strings, &memory)),
+          description(desc.begin(), desc.end(), TrackedString::allocator_type(MemoryTag::Strings, &memory)),
+          takeable(take) {}
+
+    // A copy gets its own account and starts out held by nobody
+    Item(const Item& other) : Item(toStdString(other.name), toStdString(other.description), other.takeable) {}
+    Item& operator=(const Item&) = delete;
 
-    virtual ~Item() = default; // Virtual destructor for potential inheritance
+    // Virtual destructor for potential inheritance; also takes this item's
+    // bytes back out of whichever room still holds it
+    virtual ~Item() { memory.reparent(nullptr); }
 
     virtual void look() const {
         std::cout << description << std::endl;
@@ -31,34 +198,239 @@ public:
 
     // Basic function to get item name (lowercase for comparisons)
     std::string getNameLower() const {
-        std::string lowerName = name;
+        std::string lowerName = toStdString(name);
         std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
         return lowerName;
     }
 };
 
+// Bytes of the block allocate_shared gets for one T through TrackedAllocator<T>,
+// control block included. The object's own account lives inside that block, so
+// it cannot be the allocator's owner; instead one sample is built against a
+// scratch owner to see what the allocator actually hands out.
+template <typename T, typename... Args>
+std::size_t sharedBlockBytes(MemoryTag tag, Args&&... sampleArgs) {
+    MemoryAccount scratch;
+    std::size_t bytes = 0;
+    {
+        auto sample = std::allocate_shared<T>(TrackedAllocator<T>(tag, &scratch), std::forward<Args>(sampleArgs)...);
+        bytes = static_cast<std::size_t>(scratch.bytes.load(std::memory_order_relaxed));
+    }
+    return bytes;
+}
+
+// Items are allocated through the tracked allocator so they show up under "items";
+// the whole block is also charged to the item's own account
+template <typename... Args>
+std::shared_ptr<Item> makeItem(Args&&... args) {
+    static const std::size_t blockBytes = sharedBlockBytes<Item>(MemoryTag::Items, "", "", false);
+    auto item = std::allocate_shared<Item>(TrackedAllocator<Item>(MemoryTag::Items), std::forward<Args>(args)...);
+    item->memory.charge(blockBytes);
+    return item;
+}
+
+// Containers of item pointers, charged to the given subsystem
+template <MemoryTag Tag>
+using ItemList = std::vector<std::shared_ptr<Item>, TrackedAllocator<std::shared_ptr<Item>, Tag>>;
+
+//-----------------------------------------------------------------------------
+// TextTemplate Class Definition
+//-----------------------------------------------------------------------------
+// Values a room description can refer to, e.g. "{items} item{items:s} left".
+struct TemplateContext {
+    long long items = 0;
+    long long exits = 0;
+    long long players = 0;
+    const TrackedString* name = nullptr;
+};
+
+// A description compiled once into literal slices and typed slot opcodes.
+// A counted slot with ":s" appended, e.g. {exits:s}, renders the plural suffix:
+// "s" unless the count is exactly one.
+// Rendering appends straight into the caller's output buffer; the last render
+// is cached together with the slot values it used, so text is only rebuilt
+// when one of those values has changed.
+class TextTemplate {
+public:
+    enum class Op : unsigned char { Literal, Items, Exits, Players, Name, ItemsPlural, ExitsPlural, PlayersPlural };
+
+    TextTemplate() = default;
+
+    // Unknown placeholders are kept as literal text. The compiled code and the
+    // render cache are also charged to owner, if given.
+    static TextTemplate compile(std::string_view text, MemoryAccount* owner = nullptr) {
+        TextTemplate compiled(owner);
+        compiled.source.assign(text.data(), text.size());
+        size_t literalStart = 0;
+        size_t pos = 0;
+        while ((pos = text.find('{', pos)) != std::string::npos) {
+            size_t close = text.find('}', pos);
+            if (close == std::string::npos) {
+                break;
+            }
+            Op op = slotFor(text.substr(pos + 1, close - pos - 1));
+            if (op == Op::Literal) {
+                pos = close + 1;
+                continue;
+            }
+            compiled.addLiteral(literalStart, pos - literalStart);
+            compiled.code.push_back({op, 0, 0});
+            // A plural suffix depends on its count, so it marks that slot as used
+            compiled.usedSlots |= 1u << static_cast<unsigned>(op) | 1u << static_cast<unsigned>(countFor(op));
+            literalStart = pos = close + 1;
+        }
+        compiled.addLiteral(literalStart, text.size() - literalStart);
+        return compiled;
+    }
+
+    bool isStatic() const { return usedSlots == 0; }
+    bool uses(Op op) const { return (usedSlots & (1u << static_cast<unsigned>(op))) != 0; }
+
+    void render(std::string& out, const TemplateContext& context) const {
+        if (isStatic()) {
+            out.append(source.data(), source.size());
+            return;
+        }
+        if (!cacheValid || !sameSlots(context, cachedContext)) {
+            cached.clear();
+            for (const Instruction& ins : code) {
+                switch (ins.op) {
+                    case Op::Literal: cached.append(source, ins.offset, ins.length); break;
+                    case Op::Items:   appendInteger(cached, context.items); break;
+                    case Op::Exits:   appendInteger(cached, context.exits); break;
+                    case Op::Players: appendInteger(cached, context.players); break;
+                    case Op::Name:    if (context.name) cached.append(context.name->data(), context.name->size()); break;
+                    case Op::ItemsPlural:   appendPlural(cached, context.items); break;
+                    case Op::ExitsPlural:   appendPlural(cached, context.exits); break;
+                    case Op::PlayersPlural: appendPlural(cached, context.players); break;
+                }
+            }
+            cachedContext = context;
+            cacheValid = true;
+        }
+        out.append(cached.data(), cached.size());
+    }
+
+    // Integer formatting without going through iostreams
+    template <typename String>
+    static void appendInteger(String& out, long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    template <typename String>
+    static void appendPlural(String& out, long long count) {
+        if (count != 1) {
+            out.push_back('s');
+        }
+    }
+
+private:
+    struct Instruction {
+        Op op;
+        unsigned offset; // Literal slice into source
+        unsigned length;
+    };
+
+    // Compiled templates and their cached renders are accounted as "caches"
+    using CacheString = std::basic_string<char, std::char_traits<char>, TrackedAllocator<char, MemoryTag::Caches>>;
+
+    CacheString source;
+    std::vector<Instruction, TrackedAllocator<Instruction, MemoryTag::Caches>> code;
+    unsigned usedSlots = 0;
+
+    mutable CacheString cached;
+    mutable TemplateContext cachedContext;
+    mutable bool cacheValid = false;
+
+    explicit TextTemplate(MemoryAccount* owner)
+        : source(CacheString::allocator_type(MemoryTag::Caches, owner)),
+          code(decltype(code)::allocator_type(MemoryTag::Caches, owner)),
+          cached(CacheString::allocator_type(MemoryTag::Caches, owner)) {}
+
+    static Op slotFor(std::string_view slotName) {
+        if (slotName == "items") return Op::Items;
+        if (slotName == "exits") return Op::Exits;
+        if (slotName == "players") return Op::Players;
+        if (slotName == "name") return Op::Name;
+        if (slotName == "items:s") return Op::ItemsPlural;
+        if (slotName == "exits:s") return Op::ExitsPlural;
+        if (slotName == "players:s") return Op::PlayersPlural;
+        return Op::Literal;
+    }
+
+    // The slot whose value a plural suffix reads; other ops map to themselves
+    static Op countFor(Op op) {
+        switch (op) {
+            case Op::ItemsPlural:   return Op::Items;
+            case Op::ExitsPlural:   return Op::Exits;
+            case Op::PlayersPlural: return Op::Players;
+            default:                return op;
+        }
+    }
+
+    void addLiteral(size_t offset, size_t length) {
+        if (length > 0) {
+            code.push_back({Op::Literal, static_cast<unsigned>(offset), static_cast<unsigned>(length)});
+        }
+    }
+
+    // Only the slots this template uses decide whether the cache is stale
+    bool sameSlots(const TemplateContext& a, const TemplateContext& b) const {
+        return (!uses(Op::Items) || a.items == b.items)
+            && (!uses(Op::Exits) || a.exits == b.exits)
+            && (!uses(Op::Players) || a.players == b.players)
+            && (!uses(Op::Name) || (a.name && b.name && *a.name == *b.name));
+    }
+};
+
 //-----------------------------------------------------------------------------
 // Room Class Definition
 //-----------------------------------------------------------------------------
 class Room {
 public:
-    std::string name;
-    std::string description;
+    // Bytes of this room's block (charged by makeRoom), its text, exits, item
+    // list and compiled description, plus those of the items it holds, which
+    // are re-parented on add and remove
+    MemoryAccount memory;
+    TrackedString name;
+    TrackedString description;
     // Exits: map direction (lowercase string) to another Room pointer
-    std::map<std::string, Room*> exits;
+    using ExitMap = std::map<std::string, Room*, std::less<std::string>,
+                             TrackedAllocator<std::pair<const std::string, Room*>>>;
+    ExitMap exits;
     // Items currently in the room
-    std::vector<std::shared_ptr<Item>> items;
-
-    Room(std::string n, std::string desc) : name(n), description(desc) {}
-
-    virtual ~Room() = default;
+    ItemList<MemoryTag::Other> items;
+    // Number of players currently standing here
+    int playerCount = 0;
+    // Description compiled once so look() only fills in the {slots}
+    TextTemplate descriptionTemplate;
+
+    Room(const std::string& n, const std::string& desc)
+        : name(n.begin(), n.end(), TrackedString::allocator_type(MemoryTag::Strings, &memory)),
+          description(desc.begin(), desc.end(), TrackedString::allocator_type(MemoryTag::Strings, &memory)),
+          exits(ExitMap::allocator_type(MemoryTag::Exits, &memory)),
+          items(ItemList<MemoryTag::Other>::allocator_type(MemoryTag::Items, &memory)),
+          descriptionTemplate(TextTemplate::compile(desc, &memory)) {}
+
+    virtual ~Room() {
+        for (const auto& item : items) {
+            if (item->memory.parent == &memory) {
+                item->memory.reparent(nullptr);
+            }
+        }
+    }
 
     // Describe the room, its items, and exits
     virtual void look() const {
         printSeparator();
         std::cout << "Location: " << name << std::endl;
         printSeparator();
-        std::cout << description << std::endl;
+        std::string text;
+        renderDescription(text);
+        text += '\n';
+        std::cout.write(text.data(), text.size());
 
         // List visible items
         if (!items.empty()) {
@@ -82,6 +454,16 @@ public:
         printSeparator();
     }
 
+    // Appends the description, with template slots filled in, to out
+    void renderDescription(std::string& out) const {
+        TemplateContext context;
+        context.items = static_cast<long long>(items.size());
+        context.exits = static_cast<long long>(exits.size());
+        context.players = playerCount;
+        context.name = &name;
+        descriptionTemplate.render(out, context);
+    }
+
     // Get pointer to an exit room by direction
     Room* getExit(const std::string& direction) const {
         auto it = exits.find(direction);
@@ -102,6 +484,7 @@ public:
     void addItem(std::shared_ptr<Item> item) {
         if (item) {
             items.push_back(item);
+            item->memory.reparent(&memory);
         }
     }
 
@@ -111,6 +494,7 @@ public:
             if ((*it)->getNameLower() == itemNameLower) {
                 std::shared_ptr<Item> foundItem = *it;
                 items.erase(it); // Remove item from room's vector
+                foundItem->memory.reparent(nullptr);
                 return foundItem; // Return the removed item
             }
         }
@@ -133,6 +517,15 @@ public:
     }
 };
 
+// Rooms are allocated through the tracked allocator so they show up under "rooms";
+// the whole block is also charged to the room's own account
+inline std::shared_ptr<Room> makeRoom(const std::string& name, const std::string& description) {
+    static const std::size_t blockBytes = sharedBlockBytes<Room>(MemoryTag::Rooms, std::string(), std::string());
+    auto room = std::allocate_shared<Room>(TrackedAllocator<Room>(MemoryTag::Rooms), name, description);
+    room->memory.charge(blockBytes);
+    return room;
+}
+
 
 //-----------------------------------------------------------------------------
 // Player Class Definition
@@ -140,16 +533,24 @@ public:
 class Player {
 public:
     Room* currentLocation; // Pointer to the room the player is in
-    std::vector<std::shared_ptr<Item>> inventory;
+    ItemList<MemoryTag::Sessions> inventory;
 
-    Player(Room* startRoom) : currentLocation(startRoom) {}
+    Player(Room* startRoom) : currentLocation(startRoom) {
+        if (currentLocation) {
+            ++currentLocation->playerCount;
+        }
+    }
 
     virtual ~Player() = default;
 
     // Move the player to a different room
     bool moveTo(Room* newRoom) {
         if (newRoom) {
+            if (currentLocation) {
+                --currentLocation->playerCount;
+            }
             currentLocation = newRoom;
+            ++currentLocation->playerCount;
             currentLocation->look(); // Automatically look around upon entering
             return true;
         }
@@ -270,6 +671,659 @@ public:
 
 };
 
+//-----------------------------------------------------------------------------
+// SamplingProfiler Class Definition
+//-----------------------------------------------------------------------------
+// In-process CPU profiler for the thread that calls start() (the game thread).
+// A SIGPROF fires every 1/hz of that thread's CPU time and the signal handler
+// records the current call stack, tagged with the verb handleCommand is
+// executing. Samples go into a buffer allocated up front, so the handler never
+// allocates or takes a lock. A sample costs about 5-6 us including signal
+// delivery, measured on a single-core VM, so 1 kHz costs roughly 0.5-1% of CPU.
+// The CPU-time timers (setitimer, POSIX CPU clocks) only fire on a kernel tick,
+// which caps them at HZ, often 250. On Linux the samples therefore come from a
+// perf task-clock event, which is driven by a high-resolution timer. The timers
+// are only a fallback, and status reports the rate actually achieved.
+// Dumps use the "folded stack" format read by flamegraph.pl and speedscope:
+//     verb;outer_frame;...;inner_frame count
+// Link with -rdynamic so functions inside the executable get readable names.
+class SamplingProfiler {
+public:
+    static constexpr int kMaxDepth = 32;
+    static constexpr std::size_t kDefaultCapacity = 60000; // One minute at 1 kHz
+
+    // Where the samples come from
+    enum class Source { None, PerfTaskClock, ThreadCpuTimer, ProcessCpuTimer };
+
+    // Tags every sample taken while this object is alive with the given verb.
+    // Verbs are only interned while profiling, so typos don't pile up otherwise.
+    class VerbScope {
+    public:
+        explicit VerbScope(const std::string& verb)
+            : previous(currentVerb.load(std::memory_order_relaxed)) {
+            currentVerb.store(active ? internVerb(verb) : nullptr, std::memory_order_relaxed);
+        }
+        ~VerbScope() { currentVerb.store(previous, std::memory_order_relaxed); }
+
+        VerbScope(const VerbScope&) = delete;
+        VerbScope& operator=(const VerbScope&) = delete;
+
+    private:
+        const char* previous;
+    };
+
+    static bool supported() { return TEXTADV_HAS_PROFILER != 0; }
+    static bool running() { return active; }
+    static Source source() { return sampleSource; }
+
+    static const char* sourceName(Source from) {
+        switch (from) {
+            case Source::PerfTaskClock:   return "perf task clock";
+            case Source::ThreadCpuTimer:  return "thread CPU timer, kernel tick resolution";
+            case Source::ProcessCpuTimer: return "process CPU timer, kernel tick resolution";
+            default:                      return "none";
+        }
+    }
+
+    // Samples per second of profiled CPU time since start(), up to stop()
+    static double achievedHz() {
+        double seconds = (active ? cpuSeconds() : stopCpuSeconds) - startCpuSeconds;
+        return seconds > 0 ? nextSample.load(std::memory_order_relaxed) / seconds : 0.0;
+    }
+
+    // Number of samples recorded (and lost to a full buffer) since start()
+    static std::size_t sampleCount() {
+        return std::min(nextSample.load(std::memory_order_relaxed), samples.size());
+    }
+    static std::size_t droppedCount() {
+        std::size_t taken = nextSample.load(std::memory_order_relaxed);
+        return taken > samples.size() ? taken - samples.size() : 0;
+    }
+
+    // Clears previous samples and starts sampling at the given rate
+    static bool start(int hz, std::size_t capacity = kDefaultCapacity) {
+#if TEXTADV_HAS_PROFILER
+        if (active || hz <= 0 || hz > 10000 || capacity == 0) {
+            return false;
+        }
+        samples.assign(capacity, Sample{});
+        nextSample.store(0, std::memory_order_relaxed);
+        intervalMicros = 1000000 / hz;
+
+        // backtrace() loads libgcc lazily on first use, which allocates.
+        // Do that here rather than inside the signal handler.
+        void* warmup[kMaxDepth];
+        backtrace(warmup, kMaxDepth);
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = &SamplingProfiler::onSignal;
+        action.sa_flags = SA_RESTART; // Don't interrupt blocking reads of player input
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+            return false;
+        }
+        if (!openSource()) {
+            sigaction(SIGPROF, &previousAction, nullptr);
+            return false;
+        }
+        active = true;
+        startCpuSeconds = cpuSeconds();
+        setSampling(true);
+        return true;
+#else
+        (void)hz;
+        (void)capacity;
+        return false;
+#endif
+    }
+
+    static void stop() {
+#if TEXTADV_HAS_PROFILER
+        if (!active) {
+            return;
+        }
+        setSampling(false);
+        stopCpuSeconds = cpuSeconds();
+        closeSource();
+        // Ignoring SIGPROF discards any sample signal still queued, which the
+        // default action would otherwise turn into process termination
+        signal(SIGPROF, SIG_IGN);
+        sigaction(SIGPROF, &previousAction, nullptr);
+        active = false;
+#endif
+    }
+
+    // Writes the collected samples as folded stacks. Sampling is paused while
+    // the buffer is read and resumed afterwards.
+    static bool dumpFolded(const std::string& path) {
+#if TEXTADV_HAS_PROFILER
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+        if (active) {
+            setSampling(false);
+        }
+
+        std::map<void*, std::string> symbols;
+        std::map<std::string, std::size_t> folded;
+        std::size_t count = sampleCount();
+        for (std::size_t i = 0; i < count; ++i) {
+            const Sample& sample = samples[i];
+            std::string stack = sample.verb ? sample.verb : "(no command)";
+            // Frames are innermost first; [0] is onSignal and [1] the kernel's
+            // signal trampoline, so the interrupted code starts at kSkipFrames.
+            for (int f = sample.depth - 1; f >= kSkipFrames; --f) {
+                auto it = symbols.find(sample.frames[f]);
+                if (it == symbols.end()) {
+                    it = symbols.emplace(sample.frames[f], symbolize(sample.frames[f])).first;
+                }
+                stack += ';';
+                stack += it->second;
+            }
+            ++folded[stack];
+        }
+        for (const auto& pair : folded) {
+            out << pair.first << ' ' << pair.second << '\n';
+        }
+
+        if (active) {
+            setSampling(true);
+        }
+        return static_cast<bool>(out);
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+private:
+    static constexpr int kSkipFrames = 2;
+
+    struct Sample {
+        const char* verb = nullptr;
+        int depth = 0;
+        void* frames[kMaxDepth] = {};
+    };
+
+    static inline std::vector<Sample, TrackedAllocator<Sample>> samples{TrackedAllocator<Sample>(MemoryTag::Journal)};
+    static inline std::atomic<std::size_t> nextSample{0};
+    static inline std::atomic<const char*> currentVerb{nullptr};
+    static inline std::set<std::string> verbNames; // Nodes never move, so c_str() stays valid
+    static inline bool active = false;
+    static inline long intervalMicros = 0;
+    static inline Source sampleSource = Source::None;
+    static inline double startCpuSeconds = 0;
+    static inline double stopCpuSeconds = 0;
+#if TEXTADV_HAS_PROFILER
+    static inline struct sigaction previousAction;
+#if defined(__linux__)
+    static inline int perfFd = -1;
+    static inline timer_t cpuTimer{};
+#endif
+#endif
+
+    static const char* internVerb(const std::string& verb) {
+        return verbNames.insert(verb).first->c_str();
+    }
+
+#if TEXTADV_HAS_PROFILER
+    // CPU time of whatever the sample source measures
+    static double cpuSeconds() {
+#if defined(__linux__)
+        timespec now;
+        clock_gettime(sampleSource == Source::ProcessCpuTimer ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+#else
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+    }
+
+    // Sets up the best available source for the calling thread, disarmed
+    static bool openSource() {
+#if defined(__linux__)
+        pid_t thread = static_cast<pid_t>(syscall(SYS_gettid));
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_TASK_CLOCK;
+        attr.sample_period = static_cast<std::uint64_t>(intervalMicros) * 1000; // In nanoseconds
+        attr.disabled = 1;
+        // Count time spent in the kernel on the thread's behalf (page faults,
+        // allocation) where perf_event_paranoid allows it, user time otherwise
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, thread, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (fd < 0) {
+            attr.exclude_kernel = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, thread, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        }
+        if (fd >= 0) {
+            // Each counter overflow raises SIGPROF on this thread
+            f_owner_ex owner{F_OWNER_TID, thread};
+            if (fcntl(fd, F_SETFL, O_ASYNC) == 0 && fcntl(fd, F_SETSIG, SIGPROF) == 0 &&
+                fcntl(fd, F_SETOWN_EX, &owner) == 0) {
+                perfFd = fd;
+                sampleSource = Source::PerfTaskClock;
+                return true;
+            }
+            close(fd);
+        }
+
+        // perf is often disabled in containers; fall back to a CPU-time timer
+        sigevent event;
+        std::memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = SIGPROF;
+        event._sigev_un._tid = thread;
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &cpuTimer) == 0) {
+            sampleSource = Source::ThreadCpuTimer;
+            return true;
+        }
+        return false;
+#else
+        sampleSource = Source::ProcessCpuTimer;
+        return true;
+#endif
+    }
+
+    static void closeSource() {
+#if defined(__linux__)
+        if (sampleSource == Source::PerfTaskClock) {
+            close(perfFd);
+            perfFd = -1;
+        } else if (sampleSource == Source::ThreadCpuTimer) {
+            timer_delete(cpuTimer);
+        }
+#endif
+    }
+
+    // Pauses or resumes sampling without losing the source
+    static void setSampling(bool on) {
+        long micros = on ? intervalMicros : 0;
+#if defined(__linux__)
+        if (sampleSource == Source::PerfTaskClock) {
+            ioctl(perfFd, on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+            return;
+        }
+        if (sampleSource == Source::ThreadCpuTimer) {
+            itimerspec spec;
+            spec.it_interval.tv_sec = micros / 1000000;
+            spec.it_interval.tv_nsec = (micros % 1000000) * 1000;
+            spec.it_value = spec.it_interval;
+            timer_settime(cpuTimer, 0, &spec, nullptr);
+            return;
+        }
+#endif
+        itimerval timer;
+        timer.it_interval.tv_sec = micros / 1000000;
+        timer.it_interval.tv_usec = micros % 1000000;
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_PROF, &timer, nullptr);
+    }
+
+    // Runs in signal context: only lock-free atomics and backtrace() allowed
+    static void onSignal(int) {
+        int savedErrno = errno;
+        std::size_t slot = nextSample.fetch_add(1, std::memory_order_relaxed);
+        if (slot < samples.size()) {
+            Sample& sample = samples[slot];
+            sample.verb = currentVerb.load(std::memory_order_relaxed);
+            sample.depth = backtrace(sample.frames, kMaxDepth);
+        }
+        errno = savedErrno;
+    }
+
+    // Turns a return address into a demangled function name
+    static std::string symbolize(void* address) {
+        std::string name;
+        char** described = backtrace_symbols(&address, 1);
+        if (described) {
+            // glibc format: "module(mangled+0x1f) [0x5555...]"
+            std::string text = described[0];
+            std::free(described);
+            size_t open = text.find('(');
+            size_t plus = text.find_first_of("+)", open);
+            if (open != std::string::npos && plus != std::string::npos && plus > open + 1) {
+                name = text.substr(open + 1, plus - open - 1);
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+                if (status == 0 && demangled) {
+                    name = demangled;
+                }
+                std::free(demangled);
+            }
+        }
+        if (name.empty()) {
+            std::ostringstream hex;
+            hex << address;
+            name = hex.str();
+        }
+        std::replace(name.begin(), name.end(), ';', ':'); // ';' separates frames
+        return name;
+    }
+#endif
+};
+
+
+//-----------------------------------------------------------------------------
+// TraceRing Class Definition
+//-----------------------------------------------------------------------------
+// Fixed-size, per-thread ring of recent engine events. Recording copies a
+// timestamp and a short label into a preallocated slot; the oldest events are
+// overwritten once the ring is full. Every ring is registered globally, and the
+// watchdog snapshots all of them after a slow tick. A thread's ring outlives it:
+// on exit the ring goes back to a free list for the next new thread, so a report
+// still shows what a finished bulk worker did, and the number of rings only
+// grows to the peak number of threads.
+class TraceRing {
+public:
+    static constexpr std::size_t kCapacity = 4096;
+    static constexpr std::size_t kDetailLength = 52;
+
+    struct Event {
+        std::int64_t timeNanos = 0;
+        const char* category = nullptr; // Always a string literal
+        std::uint32_t ring = 0;         // Which thread's ring it came from, set by snapshot()
+        char detail[kDetailLength] = {};
+    };
+
+    // The ring belonging to the calling thread
+    static TraceRing& local() {
+        thread_local Lease lease;
+        return *lease.ring;
+    }
+
+    // Copies out the events of every ring recorded at or after sinceNanos, oldest first
+    static std::vector<Event> snapshotAll(std::int64_t sinceNanos) {
+        Registry& registry = TraceRing::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<Event> merged;
+        for (const auto& ring : registry.rings) {
+            std::vector<Event> recent = ring->snapshot(sinceNanos);
+            merged.insert(merged.end(), recent.begin(), recent.end());
+        }
+        std::stable_sort(merged.begin(), merged.end(),
+                         [](const Event& a, const Event& b) { return a.timeNanos < b.timeNanos; });
+        return merged;
+    }
+
+    static std::int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(const char* category, std::string_view detail) {
+        std::lock_guard<std::mutex> lock(mutex); // Uncontended unless a snapshot is running
+        Event& event = events[next % kCapacity];
+        event.timeNanos = nowNanos();
+        event.category = category;
+        std::size_t length = std::min(detail.size(), kDetailLength - 1);
+        std::memcpy(event.detail, detail.data(), length);
+        event.detail[length] = '\0';
+        ++next;
+    }
+
+    // Copies out the events recorded at or after sinceNanos, oldest first
+    std::vector<Event> snapshot(std::int64_t sinceNanos) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Event> recent;
+        std::size_t count = std::min<std::size_t>(next, kCapacity);
+        for (std::size_t i = next - count; i < next; ++i) {
+            const Event& event = events[i % kCapacity];
+            if (event.timeNanos >= sinceNanos) {
+                recent.push_back(event);
+                recent.back().ring = id;
+            }
+        }
+        return recent;
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TraceRing>> rings;
+        std::vector<TraceRing*> idle; // Rings whose thread has exited
+    };
+
+    // Hands the calling thread a ring for its lifetime
+    struct Lease {
+        TraceRing* ring = nullptr;
+
+        Lease() {
+            Registry& registry = TraceRing::registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            if (!registry.idle.empty()) {
+                ring = registry.idle.back();
+                registry.idle.pop_back();
+            } else {
+                registry.rings.push_back(std::make_unique<TraceRing>());
+                ring = registry.rings.back().get();
+                ring->id = static_cast<std::uint32_t>(registry.rings.size() - 1);
+            }
+        }
+
+        ~Lease() {
+            Registry& registry = TraceRing::registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.idle.push_back(ring);
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+    };
+
+    // Constructed by the first Lease, so it outlives every thread_local one
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    std::vector<Event, TrackedAllocator<Event>> events{kCapacity, Event{}, TrackedAllocator<Event>(MemoryTag::Journal)};
+    std::size_t next = 0;
+    std::uint32_t id = 0;
+    mutable std::mutex mutex;
+};
+
+
+//-----------------------------------------------------------------------------
+// TickWatchdog Class Definition
+//-----------------------------------------------------------------------------
+// Measures each game tick (one processed input line) and each command against
+// a latency budget. Within budget the only cost is two steady_clock reads and a
+// compare; an overrun writes the offending command and the last few seconds of
+// every thread's TraceRing to "<prefix>-<kind>-<n>.trace".
+class TickWatchdog {
+public:
+    enum class Kind { Tick, Command };
+
+    // Times the enclosing block; `text` must outlive the scope
+    class Scope {
+    public:
+        Scope(TickWatchdog& dog, Kind scopeKind, const std::string& scopeText)
+            : watchdog(dog), kind(scopeKind), text(scopeText), startNanos(TraceRing::nowNanos()) {}
+
+        ~Scope() {
+            std::int64_t elapsed = TraceRing::nowNanos() - startNanos;
+            if (elapsed > watchdog.budgetNanos(kind)) {
+                watchdog.reportOverrun(kind, text, startNanos, elapsed);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TickWatchdog& watchdog;
+        Kind kind;
+        const std::string& text;
+        std::int64_t startNanos;
+    };
+
+    std::int64_t tickBudgetMicros = 50000;
+    std::int64_t commandBudgetMicros = 20000;
+    int windowSeconds = 5;      // How much trace history to save with a report
+    int cooldownMillis = 1000;  // Minimum gap between two reports
+    std::string filePrefix = "slow";
+
+    std::int64_t budgetNanos(Kind kind) const {
+        return (kind == Kind::Tick ? tickBudgetMicros : commandBudgetMicros) * 1000;
+    }
+
+    int overrunCount() const { return overruns; }
+    int reportCount() const { return reports; }
+    const std::string& lastReport() const { return lastReportPath; }
+
+private:
+    int overruns = 0;
+    int reports = 0;
+    std::int64_t lastReportNanos = 0;
+    std::string lastReportPath;
+
+    // Slow path, kept out of line so the Scope destructor stays small
+    __attribute__((noinline)) void reportOverrun(Kind kind, const std::string& text,
+                                                 std::int64_t startNanos, std::int64_t elapsedNanos) {
+        ++overruns;
+        std::int64_t now = startNanos + elapsedNanos;
+        if (reports > 0 && now - lastReportNanos < std::int64_t(cooldownMillis) * 1000000) {
+            return; // Still cooling down; don't flood the disk during a stall
+        }
+        lastReportNanos = now;
+
+        const char* kindName = (kind == Kind::Tick ? "tick" : "command");
+        std::string path = filePrefix + "-" + kindName + "-" + std::to_string(++reports) + ".trace";
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Watchdog: could not write " << path << std::endl;
+            return;
+        }
+
+        out << "kind: " << kindName << "\n";
+        out << "command: " << text << "\n";
+        out << "duration_us: " << elapsedNanos / 1000 << "\n";
+        out << "budget_us: " << budgetNanos(kind) / 1000 << "\n";
+        out << "trace (last " << windowSeconds << " s, all threads, offsets relative to start of " << kindName << "):\n";
+        for (const auto& event : TraceRing::snapshotAll(now - std::int64_t(windowSeconds) * 1000000000)) {
+            out << "  " << (event.timeNanos - startNanos) / 1000 << " us  ring " << event.ring << "  "
+                << event.category << "  " << event.detail << "\n";
+        }
+        lastReportPath = path;
+    }
+};
+
+
+//-----------------------------------------------------------------------------
+// BulkOperations Class Definition
+//-----------------------------------------------------------------------------
+// Queues large admin mutations ("spawn 1M coins", "clear a region") and runs
+// them at the next tick boundary, when no command is touching the world.
+// Rooms are split into contiguous shards, one per hardware thread, and each
+// shard is processed by its own thread. A room belongs to exactly one shard,
+// so workers never share a Room and need no locking.
+class BulkOperations {
+public:
+    // Mutates the rooms of one shard and returns the number of item mutations
+    using ShardWork = std::function<std::size_t(const std::vector<Room*>& shardRooms,
+                                                std::size_t shardIndex, std::size_t shardCount)>;
+
+    struct Result {
+        std::string description;
+        std::size_t mutations = 0;
+        double seconds = 0.0;
+        std::size_t shards = 0;
+
+        double mutationsPerSecond() const { return seconds > 0.0 ? mutations / seconds : 0.0; }
+    };
+
+    void enqueue(std::string description, ShardWork work) {
+        pending.push_back({std::move(description), std::move(work)});
+    }
+
+    bool hasPending() const { return !pending.empty(); }
+
+    // Runs every queued operation over the given rooms, in the order queued
+    std::vector<Result> applyPending(const std::vector<std::shared_ptr<Room>>& rooms) {
+        std::vector<Result> results;
+        std::vector<std::vector<Room*>> shards = makeShards(rooms);
+        for (auto& operation : pending) {
+            TraceRing::local().record("bulk", operation.description);
+            auto start = std::chrono::steady_clock::now();
+
+            std::vector<std::size_t> counts(shards.size(), 0);
+            std::vector<std::exception_ptr> errors(shards.size());
+            // Never throws, so every started worker is always joined below
+            auto runShard = [&](std::size_t shard) {
+                char label[64];
+                std::snprintf(label, sizeof(label), "shard %zu: %zu rooms", shard, shards[shard].size());
+                try {
+                    TraceRing::local().record("shard", label);
+                    counts[shard] = operation.work(shards[shard], shard, shards.size());
+                    TraceRing::local().record("shard-done", label);
+                } catch (...) {
+                    errors[shard] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            std::size_t started = 1;
+            try {
+                workers.reserve(shards.size() - 1);
+                for (; started < shards.size(); ++started) {
+                    workers.emplace_back(runShard, started);
+                }
+            } catch (...) {
+                // Out of threads (or memory): the game thread runs the shards that
+                // didn't get a worker, so the operation still applies in full
+            }
+            runShard(0); // The game thread takes the first shard itself
+            for (std::size_t shard = started; shard < shards.size(); ++shard) {
+                runShard(shard);
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            Result result;
+            result.description = operation.description;
+            result.shards = shards.size();
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (std::size_t shard = 0; shard < shards.size(); ++shard) {
+                if (errors[shard]) {
+                    pending.clear();
+                    std::rethrow_exception(errors[shard]);
+                }
+                result.mutations += counts[shard];
+            }
+            results.push_back(result);
+        }
+        pending.clear();
+        return results;
+    }
+
+private:
+    struct Operation {
+        std::string description;
+        ShardWork work;
+    };
+
+    std::vector<Operation> pending;
+
+    static std::vector<std::vector<Room*>> makeShards(const std::vector<std::shared_ptr<Room>>& rooms) {
+        std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t shardCount = std::max<std::size_t>(1, std::min(threads, rooms.size()));
+        std::vector<std::vector<Room*>> shards(shardCount);
+        for (std::size_t shard = 0; shard < shardCount; ++shard) {
+            std::size_t first = rooms.size() * shard / shardCount;
+            std::size_t last = rooms.size() * (shard + 1) / shardCount;
+            for (std::size_t i = first; i < last; ++i) {
+                shards[shard].push_back(rooms[i].get());
+            }
+        }
+        return shards;
+    }
+};
+
+
 //-----------------------------------------------------------------------------
 // Game Class Definition (Manages the overall game state and loop)
 //-----------------------------------------------------------------------------
@@ -279,6 +1333,10 @@ private:
     // Using smart pointers for rooms to manage memory automatically
     std::vector<std::shared_ptr<Room>> allRooms;
     bool gameOver;
+    bool quitRequested = false;    // Confirmed after the tick, outside the watchdog's timers
+    TickWatchdog watchdog;
+    BulkOperations bulkOperations; // Admin mutations waiting for the next tick boundary
+    std::string memoryFeedPath;    // Metrics file rewritten every tick, if set
 
     // --- Helper Functions ---
 
@@ -310,22 +1368,18 @@ private:
 
     // Handles the player's command
     void handleCommand(const std::string& verb, const std::string& noun) {
+        SamplingProfiler::VerbScope profilerTag(verb); // Attribute CPU samples to this verb
+        TraceRing& trace = TraceRing::local();
+        trace.record("command", verb);
+
         if (verb == "quit" || verb == "exit") {
-            std::cout << "Are you sure you want to quit? (yes/no): ";
-            std::string confirmation;
-            std::getline(std::cin, confirmation);
-             std::transform(confirmation.begin(), confirmation.end(), confirmation.begin(), ::tolower);
-            if (confirmation == "yes" || confirmation == "y") {
-                 gameOver = true;
-                 std::cout << "\nGoodbye! Thanks for playing." << std::endl;
-            } else {
-                std::cout << "Okay, continuing game." << std::endl;
-            }
+            quitRequested = true; // Waiting for the player's answer isn't command time
 
         } else if (verb == "look") {
             if (noun.empty()) {
                 player.look(); // Look around the room
             } else {
+                trace.record("look", noun);
                 player.lookAt(noun); // Look at specific item/feature
             }
         } else if (verb == "go" || verb == "move" || verb == "walk") {
@@ -334,18 +1388,23 @@ private:
              } else {
                 // Allow multi-word directions like "north west" if needed later
                 // For now, assume single word direction
+                trace.record("go", noun);
                 player.go(noun);
              }
         } else if (verb == "take" || verb == "get" || verb == "pickup") {
              if (noun.empty()) {
                 std::cout << "Take what?" << std::endl;
              } else {
+                 trace.record("take", noun);
                  player.take(noun);
              }
         } else if (verb == "inventory" || verb == "i") {
              player.showInventory();
         } else if (verb == "help" || verb == "?") {
              printHelp();
+        } else if (verb == "admin") {
+             trace.record("admin", noun);
+             handleAdmin(noun);
         }
          // --- Add more commands here ---
         // Example: Use item
@@ -359,6 +1418,342 @@ private:
         }
     }
 
+    // Asks the player to confirm a quit. Called between ticks, since the time
+    // spent waiting for the answer would otherwise count against the budgets.
+    void confirmQuit() {
+        std::cout << "Are you sure you want to quit? (yes/no): ";
+        std::string confirmation;
+        std::getline(std::cin, confirmation);
+        std::transform(confirmation.begin(), confirmation.end(), confirmation.begin(), ::tolower);
+        if (confirmation == "yes" || confirmation == "y") {
+            gameOver = true;
+            std::cout << "\nGoodbye! Thanks for playing." << std::endl;
+        } else {
+            std::cout << "Okay, continuing game." << std::endl;
+        }
+    }
+
+    // Handles operator commands: "admin <subsystem> <action> [args]"
+    void handleAdmin(const std::string& args) {
+        std::stringstream ss(args);
+        std::string subsystem, action;
+        ss >> subsystem >> action;
+        std::transform(subsystem.begin(), subsystem.end(), subsystem.begin(), ::tolower);
+        std::transform(action.begin(), action.end(), action.begin(), ::tolower);
+
+        if (subsystem == "profile") {
+            handleProfileCommand(action, ss);
+        } else if (subsystem == "watchdog") {
+            handleWatchdogCommand(action, ss);
+        } else if (subsystem == "bulk") {
+            handleBulkCommand(action, ss);
+        } else if (subsystem == "memory") {
+            handleMemoryCommand(action, ss);
+        } else {
+            std::cout << "Admin commands:" << std::endl;
+            std::cout << "  admin profile start [hz] : Start the CPU sampling profiler (default 1000 Hz)." << std::endl;
+            std::cout << "  admin profile stop       : Stop sampling." << std::endl;
+            std::cout << "  admin profile status     : Show sample counts." << std::endl;
+            std::cout << "  admin profile dump [file]: Write folded stacks for flamegraph.pl." << std::endl;
+            std::cout << "  admin watchdog status    : Show latency budgets and overruns." << std::endl;
+            std::cout << "  admin watchdog tick|command <us> : Set a latency budget in microseconds." << std::endl;
+            std::cout << "  admin watchdog window <seconds>  : Trace history saved with each report." << std::endl;
+            std::cout << "  admin bulk spawn <count> <item>  : Copy an item into random rooms." << std::endl;
+            std::cout << "  admin bulk clear <region|all>    : Remove takeable items from matching rooms." << std::endl;
+            std::cout << "  admin bulk rename <item> = <new> : Rename every copy of an item." << std::endl;
+            std::cout << "  admin memory report [n]   : Bytes per subsystem and the n largest rooms." << std::endl;
+            std::cout << "  admin memory feed <file|off>     : Rewrite a metrics file every tick." << std::endl;
+        }
+    }
+
+    void handleMemoryCommand(const std::string& action, std::stringstream& args) {
+        if (action == "report" || action.empty()) {
+            long long topN = 5;
+            if (!(args >> std::ws).eof() && (!(args >> topN) || topN <= 0)) {
+                std::cout << "Usage: admin memory report [n]" << std::endl;
+                return;
+            }
+            printMemoryReport(static_cast<std::size_t>(topN));
+        } else if (action == "feed") {
+            std::string path;
+            args >> path;
+            if (path.empty()) {
+                std::cout << "Usage: admin memory feed <file|off>" << std::endl;
+            } else if (path == "off") {
+                memoryFeedPath.clear();
+                std::cout << "Memory feed disabled." << std::endl;
+            } else {
+                memoryFeedPath = path;
+                std::cout << "Writing memory metrics to " << path << " every tick." << std::endl;
+            }
+        } else {
+            std::cout << "Usage: admin memory report [n] | feed <file|off>" << std::endl;
+        }
+    }
+
+    // Rooms ordered by the bytes they hold, items included, largest first
+    std::vector<const Room*> largestRooms(std::size_t count) const {
+        std::vector<const Room*> rooms;
+        for (const auto& room : allRooms) {
+            rooms.push_back(room.get());
+        }
+        count = std::min(count, rooms.size());
+        std::partial_sort(rooms.begin(), rooms.begin() + count, rooms.end(), [](const Room* a, const Room* b) {
+            return a->memory.bytes.load(std::memory_order_relaxed) > b->memory.bytes.load(std::memory_order_relaxed);
+        });
+        rooms.resize(count);
+        return rooms;
+    }
+
+    void printMemoryReport(std::size_t topN) const {
+        Room::printSeparator('=', 40);
+        std::cout << "Memory by subsystem (bytes / allocations):" << std::endl;
+        long long total = 0;
+        for (std::size_t i = 0; i < MemoryStats::kTagCount; ++i) {
+            MemoryTag tag = static_cast<MemoryTag>(i);
+            const MemoryAccount& account = MemoryStats::subsystem(tag);
+            long long bytes = account.bytes.load(std::memory_order_relaxed);
+            total += bytes;
+            std::cout << "  " << MemoryStats::name(tag) << ": " << bytes << " / "
+                      << account.allocations.load(std::memory_order_relaxed) << std::endl;
+        }
+        std::cout << "  total: " << total << std::endl;
+
+        std::cout << "Largest rooms (room, text, exits, item lists and items):" << std::endl;
+        for (const Room* room : largestRooms(topN)) {
+            std::cout << "  " << room->name << ": " << room->memory.bytes.load(std::memory_order_relaxed)
+                      << " bytes, " << room->items.size() << " items" << std::endl;
+        }
+        Room::printSeparator('=', 40);
+    }
+
+    // Prometheus text format, written to a temporary file and renamed into place
+    void writeMemoryFeed() const {
+        std::string temporary = memoryFeedPath + ".tmp";
+        {
+            std::ofstream out(temporary);
+            if (!out) {
+                return;
+            }
+            for (std::size_t i = 0; i < MemoryStats::kTagCount; ++i) {
+                MemoryTag tag = static_cast<MemoryTag>(i);
+                const MemoryAccount& account = MemoryStats::subsystem(tag);
+                out << "textadv_memory_bytes{subsystem=\"" << MemoryStats::name(tag) << "\"} "
+                    << account.bytes.load(std::memory_order_relaxed) << "\n";
+                out << "textadv_memory_allocations{subsystem=\"" << MemoryStats::name(tag) << "\"} "
+                    << account.allocations.load(std::memory_order_relaxed) << "\n";
+            }
+            for (const Room* room : largestRooms(10)) {
+                out << "textadv_room_memory_bytes{room=\"" << room->name << "\"} "
+                    << room->memory.bytes.load(std::memory_order_relaxed) << "\n";
+            }
+        }
+        std::rename(temporary.c_str(), memoryFeedPath.c_str());
+    }
+
+    // Queues a bulk world edit; it runs at the end of the current tick
+    void handleBulkCommand(const std::string& action, std::stringstream& args) {
+        std::string rest;
+        std::getline(args, rest);
+        size_t firstChar = rest.find_first_not_of(' ');
+        rest = (firstChar == std::string::npos) ? "" : rest.substr(firstChar);
+
+        if (action == "spawn") {
+            std::stringstream spawnArgs(rest);
+            long long count = 0;
+            std::string itemName;
+            spawnArgs >> count;
+            std::getline(spawnArgs >> std::ws, itemName);
+            std::shared_ptr<Item> prototype = findItemAnywhere(itemName);
+            if (count <= 0 || !prototype) {
+                std::cout << "Usage: admin bulk spawn <count> <existing item name>" << std::endl;
+                return;
+            }
+            Item kind = *prototype;
+            std::size_t total = static_cast<std::size_t>(count);
+            bulkOperations.enqueue("spawn " + std::to_string(total) + " " + toStdString(kind.name),
+                [kind, total](const std::vector<Room*>& rooms, std::size_t shard, std::size_t shardCount) {
+                    // Each shard spawns its share of the total in its own rooms
+                    std::size_t share = total / shardCount + (shard < total % shardCount ? 1 : 0);
+                    if (rooms.empty()) {
+                        return std::size_t(0);
+                    }
+                    std::mt19937_64 rng(std::random_device{}() + shard);
+                    std::uniform_int_distribution<std::size_t> pickRoom(0, rooms.size() - 1);
+                    std::vector<std::size_t> perRoom(rooms.size(), 0);
+                    for (std::size_t i = 0; i < share; ++i) {
+                        ++perRoom[pickRoom(rng)];
+                    }
+                    for (std::size_t r = 0; r < rooms.size(); ++r) {
+                        rooms[r]->items.reserve(rooms[r]->items.size() + perRoom[r]);
+                        for (std::size_t i = 0; i < perRoom[r]; ++i) {
+                            rooms[r]->addItem(makeItem(kind));
+                        }
+                    }
+                    return share;
+                });
+        } else if (action == "clear") {
+            std::string region = rest;
+            std::transform(region.begin(), region.end(), region.begin(), ::tolower);
+            if (region.empty()) {
+                std::cout << "Usage: admin bulk clear <part of a room name | all>" << std::endl;
+                return;
+            }
+            bulkOperations.enqueue("clear " + region,
+                [region](const std::vector<Room*>& rooms, std::size_t, std::size_t) {
+                    std::size_t removed = 0;
+                    for (Room* room : rooms) {
+                        std::string roomName = toStdString(room->name);
+                        std::transform(roomName.begin(), roomName.end(), roomName.begin(), ::tolower);
+                        if (region != "all" && roomName.find(region) == std::string::npos) {
+                            continue;
+                        }
+                        // Scenery can't be picked up, so only takeable items count as dropped.
+                        // The dropped items leave the room's account as they are destroyed.
+                        auto firstRemoved = std::remove_if(room->items.begin(), room->items.end(),
+                            [](const std::shared_ptr<Item>& item) { return item->takeable; });
+                        removed += room->items.end() - firstRemoved;
+                        room->items.erase(firstRemoved, room->items.end());
+                    }
+                    return removed;
+                });
+        } else if (action == "rename") {
+            size_t equals = rest.find('=');
+            std::string from = rest.substr(0, equals);
+            std::string to = (equals == std::string::npos) ? "" : rest.substr(equals + 1);
+            from.erase(from.find_last_not_of(' ') + 1);
+            to.erase(0, to.find_first_not_of(' '));
+            if (from.empty() || to.empty()) {
+                std::cout << "Usage: admin bulk rename <item name> = <new name>" << std::endl;
+                return;
+            }
+            std::transform(from.begin(), from.end(), from.begin(), ::tolower);
+            bulkOperations.enqueue("rename " + from + " to " + to,
+                [this, from, to](const std::vector<Room*>& rooms, std::size_t shard, std::size_t) {
+                    std::size_t renamed = 0;
+                    auto renameIn = [&](auto& items) {
+                        for (auto& item : items) {
+                            if (item->getNameLower() == from) {
+                                item->name.assign(to.begin(), to.end());
+                                ++renamed;
+                            }
+                        }
+                    };
+                    for (Room* room : rooms) {
+                        renameIn(room->items);
+                    }
+                    // The inventory belongs to no shard; the first one, which runs
+                    // on the game thread, renames the player's copies too
+                    if (shard == 0) {
+                        renameIn(player.inventory);
+                    }
+                    return renamed;
+                });
+        } else {
+            std::cout << "Usage: admin bulk spawn <count> <item> | clear <region|all> | rename <item> = <new>" << std::endl;
+            return;
+        }
+        std::cout << "Queued; it will run when this command finishes." << std::endl;
+    }
+
+    void applyBulkOperations() {
+        try {
+            for (const auto& result : bulkOperations.applyPending(allRooms)) {
+                std::cout << "Bulk " << result.description << ": " << result.mutations << " mutations in "
+                          << result.seconds * 1000.0 << " ms across " << result.shards << " shard(s) ("
+                          << static_cast<long long>(result.mutationsPerSecond()) << " mutations/sec)." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Bulk operation failed: " << e.what() << std::endl;
+        }
+    }
+
+    // Finds an item by name in any room or the player's inventory
+    std::shared_ptr<Item> findItemAnywhere(const std::string& itemName) const {
+        std::string lowerName = itemName;
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+        for (const auto& room : allRooms) {
+            if (std::shared_ptr<Item> item = room->findItem(lowerName)) {
+                return item;
+            }
+        }
+        for (const auto& item : player.inventory) {
+            if (item->getNameLower() == lowerName) {
+                return item;
+            }
+        }
+        return nullptr;
+    }
+
+    void handleWatchdogCommand(const std::string& action, std::stringstream& args) {
+        if (action == "tick" || action == "command") {
+            std::int64_t micros = 0;
+            if (!(args >> micros) || micros <= 0) {
+                std::cout << "Usage: admin watchdog " << action << " <microseconds>" << std::endl;
+                return;
+            }
+            (action == "tick" ? watchdog.tickBudgetMicros : watchdog.commandBudgetMicros) = micros;
+            std::cout << "Watchdog " << action << " budget set to " << micros << " us." << std::endl;
+        } else if (action == "window") {
+            int seconds = 0;
+            if (!(args >> seconds) || seconds <= 0) {
+                std::cout << "Usage: admin watchdog window <seconds>" << std::endl;
+                return;
+            }
+            watchdog.windowSeconds = seconds;
+            std::cout << "Watchdog reports will include the last " << seconds << " s of trace." << std::endl;
+        } else if (action == "status" || action.empty()) {
+            std::cout << "Watchdog budgets: tick " << watchdog.tickBudgetMicros << " us, command "
+                      << watchdog.commandBudgetMicros << " us, window " << watchdog.windowSeconds << " s." << std::endl;
+            std::cout << watchdog.overrunCount() << " overruns, " << watchdog.reportCount() << " reports written";
+            if (!watchdog.lastReport().empty()) {
+                std::cout << " (latest: " << watchdog.lastReport() << ")";
+            }
+            std::cout << "." << std::endl;
+        } else {
+            std::cout << "Usage: admin watchdog status | tick <us> | command <us> | window <seconds>" << std::endl;
+        }
+    }
+
+    void handleProfileCommand(const std::string& action, std::stringstream& args) {
+        if (!SamplingProfiler::supported()) {
+            std::cout << "The sampling profiler is not available on this platform." << std::endl;
+            return;
+        }
+
+        if (action == "start") {
+            int hz = 1000;
+            args >> hz;
+            if (SamplingProfiler::start(hz)) {
+                std::cout << "Profiler started at " << hz << " Hz of CPU time ("
+                          << SamplingProfiler::sourceName(SamplingProfiler::source())
+                          << "); 'admin profile status' shows the rate achieved." << std::endl;
+            } else {
+                std::cout << "Could not start the profiler (already running, or rate outside 1-10000 Hz)." << std::endl;
+            }
+        } else if (action == "stop") {
+            SamplingProfiler::stop();
+            std::cout << "Profiler stopped with " << SamplingProfiler::sampleCount() << " samples ("
+                      << static_cast<long long>(SamplingProfiler::achievedHz()) << " Hz achieved)." << std::endl;
+        } else if (action == "status") {
+            std::cout << "Profiler is " << (SamplingProfiler::running() ? "running" : "stopped")
+                      << ": " << SamplingProfiler::sampleCount() << " samples, "
+                      << SamplingProfiler::droppedCount() << " dropped (buffer full), "
+                      << static_cast<long long>(SamplingProfiler::achievedHz()) << " Hz achieved on "
+                      << SamplingProfiler::sourceName(SamplingProfiler::source()) << "." << std::endl;
+        } else if (action == "dump") {
+            std::string path = "profile.folded";
+            args >> path;
+            if (SamplingProfiler::dumpFolded(path)) {
+                std::cout << "Wrote " << SamplingProfiler::sampleCount() << " samples to " << path << "." << std::endl;
+            } else {
+                std::cout << "Could not write profile to " << path << "." << std::endl;
+            }
+        } else {
+            std::cout << "Usage: admin profile start [hz] | stop | status | dump [file]" << std::endl;
+        }
+    }
+
     // Prints available commands
     void printHelp() const {
         Room::printSeparator('*', 40);
@@ -372,6 +1767,7 @@ private:
         std::cout << "  inventory / i : Show items you are carrying." << std::endl;
         std::cout << "  help / ?      : Show this help message." << std::endl;
         std::cout << "  quit / exit   : Leave the game." << std::endl;
+        std::cout << "  admin         : Operator commands (profiling, watchdog, bulk edits, memory)." << std::endl;
         Room::printSeparator('*', 40);
     }
 
@@ -380,54 +1776,54 @@ private:
 
     void createWorld() {
         // --- Create Items ---
-        // Using make_shared for automatic memory management
-        auto key = std::make_shared<Item>("Rusty Key", "A small, tarnished key. It looks old.", true);
-        auto map = std::make_shared<Item>("Torn Map", "A piece of parchment with crude drawings. Part of it is missing.", true);
-        auto torch = std::make_shared<Item>("Dim Torch", "An old wooden torch, casting a weak, flickering light.", true);
-        auto sword = std::make_shared<Item>("Iron Sword", "A basic iron sword. It's seen better days but still functional.", true);
-        auto shield = std::make_shared<Item>("Wooden Shield", "A simple round wooden shield.", true);
-        auto potion = std::make_shared<Item>("Red Potion", "A small vial containing a bubbling red liquid.", true);
-        auto book = std::make_shared<Item>("Dusty Book", "A heavy tome bound in cracked leather. The title is illegible.", true);
-        auto coin = std::make_shared<Item>("Gold Coin", "A shiny gold coin.", true);
-        auto gem = std::make_shared<Item>("Blue Gem", "A sparkling blue gem.", true);
-        auto scroll = std::make_shared<Item>("Ancient Scroll", "A fragile scroll covered in strange symbols.", true);
+        // Using shared_ptr (via makeItem) for automatic memory management
+        auto key = makeItem("Rusty Key", "A small, tarnished key. It looks old.", true);
+        auto map = makeItem("Torn Map", "A piece of parchment with crude drawings. Part of it is missing.", true);
+        auto torch = makeItem("Dim Torch", "An old wooden torch, casting a weak, flickering light.", true);
+        auto sword = makeItem("Iron Sword", "A basic iron sword. It's seen better days but still functional.", true);
+        auto shield = makeItem("Wooden Shield", "A simple round wooden shield.", true);
+        auto potion = makeItem("Red Potion", "A small vial containing a bubbling red liquid.", true);
+        auto book = makeItem("Dusty Book", "A heavy tome bound in cracked leather. The title is illegible.", true);
+        auto coin = makeItem("Gold Coin", "A shiny gold coin.", true);
+        auto gem = makeItem("Blue Gem", "A sparkling blue gem.", true);
+        auto scroll = makeItem("Ancient Scroll", "A fragile scroll covered in strange symbols.", true);
 
         // Non-takeable items (scenery)
-        auto statue = std::make_shared<Item>("Stone Statue", "A large statue of a forgotten king, covered in moss.", false);
-        auto fountain = std::make_shared<Item>("Dry Fountain", "An ornate fountain, now dry and filled with leaves.", false);
-        auto altar = std::make_shared<Item>("Stone Altar", "A flat stone altar with strange carvings.", false);
-        auto tapestry = std::make_shared<Item>("Faded Tapestry", "A large, moth-eaten tapestry depicting a hunting scene.", false);
-        auto painting = std::make_shared<Item>("Oil Painting", "A painting of a stern-looking nobleman. His eyes seem to follow you.", false);
-        auto well = std::make_shared<Item>("Deep Well", "A dark well. You can't see the bottom.", false);
-        auto table = std::make_shared<Item>("Wooden Table", "A sturdy wooden table.", false);
-        auto chair = std::make_shared<Item>("Rickety Chair", "An old wooden chair that looks unsafe to sit on.", false);
-        auto bed = std::make_shared<Item>("Straw Bed", "A simple bed made of straw. Doesn't look comfortable.", false);
-        auto fireplace = std::make_shared<Item>("Cold Fireplace", "A large stone fireplace, full of ashes.", false);
+        auto statue = makeItem("Stone Statue", "A large statue of a forgotten king, covered in moss.", false);
+        auto fountain = makeItem("Dry Fountain", "An ornate fountain, now dry and filled with leaves.", false);
+        auto altar = makeItem("Stone Altar", "A flat stone altar with strange carvings.", false);
+        auto tapestry = makeItem("Faded Tapestry", "A large, moth-eaten tapestry depicting a hunting scene.", false);
+        auto painting = makeItem("Oil Painting", "A painting of a stern-looking nobleman. His eyes seem to follow you.", false);
+        auto well = makeItem("Deep Well", "A dark well. You can't see the bottom.", false);
+        auto table = makeItem("Wooden Table", "A sturdy wooden table.", false);
+        auto chair = makeItem("Rickety Chair", "An old wooden chair that looks unsafe to sit on.", false);
+        auto bed = makeItem("Straw Bed", "A simple bed made of straw. Doesn't look comfortable.", false);
+        auto fireplace = makeItem("Cold Fireplace", "A large stone fireplace, full of ashes.", false);
 
 
         // --- Create Rooms ---
         // Room naming convention: Short name (for map), Descriptive text
-        auto start_cell = std::make_shared<Room>("Damp Cell", "You are in a small, damp stone cell. The air is cold and smells of mildew.\nA single barred window is high on one wall, letting in faint moonlight.\nThe only exit seems to be a heavy wooden door to the north.");
-        auto corridor_1 = std::make_shared<Room>("Narrow Corridor", "A narrow stone corridor stretches ahead. Torches flicker dimly on the walls.\nIt continues north and south.");
-        auto guard_room = std::make_shared<Room>("Guard Room", "This looks like it was a guard room. An overturned table and a broken chair lie on the floor.\nThere's an exit west and the corridor continues south.");
-        auto armory = std::make_shared<Room>("Small Armory", "This small room is clearly an armory, though mostly empty now.\nRacks line the walls, but only a few items remain.\nAn exit leads east back to the guard room.");
-        auto main_hall = std::make_shared<Room>("Main Hall", "A large, echoing hall. Dust motes dance in the beams of light (if any).\nFaded tapestries hang on the walls. Exits lead north, south, and east.");
-        auto kitchen = std::make_shared<Room>("Abandoned Kitchen", "This was once a kitchen. Pots and pans lie scattered around.\nA large, cold fireplace dominates one wall.\nAn exit leads west back to the Main Hall.");
-        auto pantry = std::make_shared<Room>("Dusty Pantry", "A small pantry adjoining the kitchen. Shelves line the walls, mostly empty except for cobwebs and dust.\nA single exit leads south to the kitchen.");
-        auto library = std::make_shared<Room>("Quiet Library", "Rows of tall bookshelves fill this room, though many books are missing or destroyed.\nThe air smells of old paper and dust.\nAn exit leads west from the Main Hall.");
-        auto study = std::make_shared<Room>("Small Study", "A small, cluttered study. A large wooden desk sits against one wall.\nPapers are scattered everywhere.\nAn exit leads south back to the library.");
-        auto courtyard = std::make_shared<Room>("Overgrown Courtyard", "You step outside into a courtyard overgrown with weeds and thorny bushes.\nA dry fountain sits in the center.\nExits lead north (back into the Main Hall) and east (to a path).");
-        auto garden_path = std::make_shared<Room>("Garden Path", "A winding path through what was once a garden. It's wild and untamed now.\nThe path continues east and west (back to the courtyard).");
-        auto deep_forest = std::make_shared<Room>("Deep Forest", "The path ends abruptly at the edge of a dark, imposing forest.\nThe trees are thick and block out much of the light. \nYou feel watched.\nGoing back west is the only clear option for now.");
-        auto cellar_stairs = std::make_shared<Room>("Cellar Stairs", "Stone steps lead down into darkness from the main hall (south exit).\nThe air is noticeably colder here.\nStairs go down, and back up (north).");
-        auto wine_cellar = std::make_shared<Room>("Wine Cellar", "Rows of empty wine racks line the walls of this cool cellar.\nSome broken bottles crunch underfoot.\nStairs lead up. Another passage leads east.");
-        auto storage_room = std::make_shared<Room>("Storage Room", "A damp storage room filled with broken crates and barrels.\nIt smells strongly of mildew.\nThe only exit is west, back to the wine cellar.");
-        auto hidden_passage = std::make_shared<Room>("Hidden Passage", "A narrow, secret passage behind a loose stone in the storage room (requires finding/action - not implemented yet).\nIt's pitch black without a light source.\nExits lead west (back to storage) and north.");
-        auto underground_stream = std::make_shared<Room>("Underground Stream", "The passage opens into a small cavern where a slow-moving underground stream flows.\nThe water looks surprisingly clear.\nA passage leads south.");
-        auto outer_gate = std::make_shared<Room>("Outer Gate", "You've reached a large, rusted iron gate, seemingly the main entrance/exit to this place.\nIt appears stuck or locked (not implemented).\nPath leads back south into the Courtyard.");
-        auto tower_base = std::make_shared<Room>("Tower Base", "The base of a crumbling stone tower. Rubble lies scattered around.\nThere's a doorway leading inside (north) and the Garden Path is to the west.");
-        auto tower_stairs = std::make_shared<Room>("Tower Stairs", "A winding stone staircase climbs upwards inside the tower.\nIt looks unstable in places.\nStairs go up and down (south).");
-        auto tower_top = std::make_shared<Room>("Tower Top", "You are at the top of the crumbling tower. The wind whistles through gaps in the stone.\nYou have a wide view of the surrounding area (mostly forest).\nStairs lead down.");
+        auto start_cell = makeRoom("Damp Cell", "You are in a small, damp stone cell. The air is cold and smells of mildew.\nA single barred window is high on one wall, letting in faint moonlight.\nThe only exit seems to be a heavy wooden door to the north.");
+        auto corridor_1 = makeRoom("Narrow Corridor", "A narrow stone corridor stretches ahead. Torches flicker dimly on the walls.\nIt continues north and south.");
+        auto guard_room = makeRoom("Guard Room", "This looks like it was a guard room. An overturned table and a broken chair lie on the floor.\nThere's an exit west and the corridor continues south.");
+        auto armory = makeRoom("Small Armory", "This small room is clearly an armory, though mostly empty now.\nRacks line the walls, with only {items} item{items:s} left on them.\nAn exit leads east back to the guard room.");
+        auto main_hall = makeRoom("Main Hall", "A large, echoing hall. Dust motes dance in the beams of light (if any).\nFaded tapestries hang on the walls. {exits} passage{exits:s} lead out: north, south, east, west and down.");
+        auto kitchen = makeRoom("Abandoned Kitchen", "This was once a kitchen. Pots and pans lie scattered around.\nA large, cold fireplace dominates one wall.\nAn exit leads west back to the Main Hall.");
+        auto pantry = makeRoom("Dusty Pantry", "A small pantry adjoining the kitchen. Shelves line the walls, mostly empty except for cobwebs and dust.\nA single exit leads south to the kitchen.");
+        auto library = makeRoom("Quiet Library", "Rows of tall bookshelves fill this room, though many books are missing or destroyed.\nThe air smells of old paper and dust.\nAn exit leads west from the Main Hall.");
+        auto study = makeRoom("Small Study", "A small, cluttered study. A large wooden desk sits against one wall.\nPapers are scattered everywhere.\nAn exit leads south back to the library.");
+        auto courtyard = makeRoom("Overgrown Courtyard", "You step outside into a courtyard overgrown with weeds and thorny bushes.\nA dry fountain sits in the center.\nExits lead north (back into the Main Hall) and east (to a path).");
+        auto garden_path = makeRoom("Garden Path", "A winding path through what was once a garden. It's wild and untamed now.\nThe path continues east and west (back to the courtyard).");
+        auto deep_forest = makeRoom("Deep Forest", "The path ends abruptly at the edge of a dark, imposing forest.\nThe trees are thick and block out much of the light. \nYou feel watched.\nGoing back west is the only clear option for now.");
+        auto cellar_stairs = makeRoom("Cellar Stairs", "Stone steps lead down into darkness from the main hall (south exit).\nThe air is noticeably colder here.\nStairs go down, and back up (north).");
+        auto wine_cellar = makeRoom("Wine Cellar", "Rows of empty wine racks line the walls of this cool cellar.\nSome broken bottles crunch underfoot.\nStairs lead up. Another passage leads east.");
+        auto storage_room = makeRoom("Storage Room", "A damp storage room filled with broken crates and barrels.\nIt smells strongly of mildew.\nThe only exit is west, back to the wine cellar.");
+        auto hidden_passage = makeRoom("Hidden Passage", "A narrow, secret passage behind a loose stone in the storage room (requires finding/action - not implemented yet).\nIt's pitch black without a light source.\nExits lead west (back to storage) and north.");
+        auto underground_stream = makeRoom("Underground Stream", "The passage opens into a small cavern where a slow-moving underground stream flows.\nThe water looks surprisingly clear.\nA passage leads south.");
+        auto outer_gate = makeRoom("Outer Gate", "You've reached a large, rusted iron gate, seemingly the main entrance/exit to this place.\nIt appears stuck or locked (not implemented).\nPath leads back south into the Courtyard.");
+        auto tower_base = makeRoom("Tower Base", "The base of a crumbling stone tower. Rubble lies scattered around.\nThere's a doorway leading inside (north) and the Garden Path is to the west.");
+        auto tower_stairs = makeRoom("Tower Stairs", "A winding stone staircase climbs upwards inside the tower.\nIt looks unstable in places.\nStairs go up and down (south).");
+        auto tower_top = makeRoom("Tower Top", "You are at the top of the crumbling tower. The wind whistles through gaps in the stone.\nYou have a wide view of the surrounding area (mostly forest).\nStairs lead down.");
 
 
         // --- Add Rooms to Game List ---
@@ -617,18 +2013,42 @@ public:
                 continue; // Ask for input again if empty line entered
             }
 
-            parseInput(inputLine, verb, noun);
+            runTick(inputLine, verb, noun);
 
-            if (!verb.empty()) {
-                handleCommand(verb, noun);
-            }
-            // If verb is empty after parsing, likely means invalid input or just spaces
-            else if (!inputLine.empty() && inputLine.find_first_not_of(' ') != std::string::npos) {
-                // Check if input wasn't just whitespace before printing error
-                std::cout << "Please enter a valid command. Try 'help'." << std::endl;
+            // Prompts wait on the player, so they run after the tick's timers stop
+            if (quitRequested) {
+                quitRequested = false;
+                confirmQuit();
             }
         }
     }
+
+    // Processes one input line under the tick and command watchdog timers
+    void runTick(const std::string& inputLine, std::string& verb, std::string& noun) {
+        TickWatchdog::Scope tickTimer(watchdog, TickWatchdog::Kind::Tick, inputLine);
+        TraceRing::local().record("input", inputLine);
+
+        parseInput(inputLine, verb, noun);
+
+        if (!verb.empty()) {
+            TickWatchdog::Scope commandTimer(watchdog, TickWatchdog::Kind::Command, inputLine);
+            handleCommand(verb, noun);
+            TraceRing::local().record("done", player.currentLocation ? std::string_view(player.currentLocation->name) : verb);
+        }
+        // If verb is empty after parsing, likely means invalid input or just spaces
+        else if (!inputLine.empty() && inputLine.find_first_not_of(' ') != std::string::npos) {
+            // Check if input wasn't just whitespace before printing error
+            std::cout << "Please enter a valid command. Try 'help'." << std::endl;
+        }
+
+        // Tick boundary: no command is running, so queued bulk edits can apply
+        if (bulkOperations.hasPending()) {
+            applyBulkOperations();
+        }
+        if (!memoryFeedPath.empty()) {
+            writeMemoryFeed();
+        }
+    }
 };
 
 
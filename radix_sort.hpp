@@ -0,0 +1,321 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "search.hpp"
+#include "thread_pool.hpp"
+
+namespace search {
+
+/// Below this many elements radixSort falls back to std::stable_sort.
+inline constexpr std::size_t kRadixSortMinimum = 1 << 12;
+
+namespace detail {
+
+// Integer and floating-point keys of up to 64 bits
+template <typename Key>
+inline constexpr bool kRadixSortable =
+    (std::is_integral_v<Key> && !std::is_same_v<Key, bool> && sizeof(Key) <= 8) || std::is_same_v<Key, float> ||
+    std::is_same_v<Key, double>;
+
+// The key as an unsigned integer of the same width whose order matches the
+// key's: signed integers flip the sign bit; floats flip the sign bit of
+// positive values and every bit of negative ones. -0.0 sorts before +0.0,
+// and NaNs go to the ends by sign.
+template <typename Key>
+auto radixBits(Key key) {
+    if constexpr (std::is_floating_point_v<Key>) {
+        using Bits = std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        constexpr Bits sign = Bits(1) << (8 * sizeof(Bits) - 1);
+        return (bits & sign) ? Bits(~bits) : Bits(bits | sign);
+    } else {
+        using Bits = std::make_unsigned_t<Key>;
+        if constexpr (std::is_signed_v<Key>) {
+            return static_cast<Bits>(static_cast<Bits>(key) ^ (Bits(1) << (8 * sizeof(Bits) - 1)));
+        } else {
+            return static_cast<Bits>(key);
+        }
+    }
+}
+
+struct RadixIdentity {
+    template <typename U>
+    const U& operator()(const U& value) const { return value; }
+};
+
+// Elements per bucket staged before a scatter writes them out: two cache
+// lines, so the 256 buffers of a thread fit in L1
+template <typename T>
+inline constexpr std::size_t kRadixStaged = sizeof(T) >= 128 ? 1 : 128 / sizeof(T);
+
+// Each thread's share of [0, n): contiguous, in order
+struct RadixChunks {
+    std::size_t n;
+    std::size_t count;
+    std::size_t begin(std::size_t chunk) const { return chunk * n / count; }
+    std::size_t end(std::size_t chunk) const { return (chunk + 1) * n / count; }
+};
+
+// One stable counting pass of source into target by bucketOf(element), a
+// byte value. Chunks histogram their part of the input; a prefix sum over
+// (bucket, chunk) gives each chunk its own output ranges, and each chunk
+// scatters through a small staging buffer per bucket, so writes to target
+// are runs of whole cache lines. Returns where each bucket starts.
+template <typename T, typename BucketOf>
+std::array<std::size_t, 256> radixScatter(ThreadPool& pool, const RadixChunks& chunks, const T* source, T* target,
+                                          BucketOf bucketOf) {
+    constexpr std::size_t kBuckets = 256;
+    using Histogram = std::array<std::size_t, kBuckets>;
+    std::vector<Histogram> counts(chunks.count);
+    pool.parallelFor(chunks.count, [&](std::size_t chunk) {
+        Histogram local{};
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i) {
+            ++local[bucketOf(source[i])];
+        }
+        counts[chunk] = local;
+    });
+    // counts[c][b] becomes where chunk c writes its first bucket-b element:
+    // after all smaller buckets, and after bucket b of earlier chunks
+    Histogram starts{};
+    std::size_t offset = 0;
+    for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        starts[bucket] = offset;
+        for (Histogram& count : counts) {
+            std::size_t keys = count[bucket];
+            count[bucket] = offset;
+            offset += keys;
+        }
+    }
+    pool.parallelFor(chunks.count, [&](std::size_t chunk) {
+        constexpr std::size_t kStaged = kRadixStaged<T>;
+        std::vector<T> staging(kBuckets * kStaged);
+        std::array<std::size_t, kBuckets> filled{};
+        Histogram& next = counts[chunk];
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i) {
+            std::size_t bucket = bucketOf(source[i]);
+            T* stage = staging.data() + bucket * kStaged;
+            stage[filled[bucket]++] = source[i];
+            if (filled[bucket] == kStaged) {
+                std::copy(stage, stage + kStaged, target + next[bucket]);
+                next[bucket] += kStaged;
+                filled[bucket] = 0;
+            }
+        }
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            T* stage = staging.data() + bucket * kStaged;
+            std::copy(stage, stage + filled[bucket], target + next[bucket]);
+        }
+    });
+    return starts;
+}
+
+// Chunks of at least kRadixSortMinimum elements, at most one per thread
+inline RadixChunks radixChunks(const ThreadPool& pool, std::size_t n) {
+    return RadixChunks{n, std::max<std::size_t>(1, std::min(pool.size(), n / kRadixSortMinimum))};
+}
+
+// The key bits that differ between any two elements
+template <typename T, typename KeyOf>
+auto radixVaryingBits(ThreadPool& pool, const T* data, std::size_t n, KeyOf keyOf) {
+    using Bits = decltype(radixBits(keyOf(data[0])));
+    RadixChunks chunks = radixChunks(pool, n);
+    std::vector<Bits> anySet(chunks.count, 0);
+    std::vector<Bits> allSet(chunks.count, static_cast<Bits>(~Bits(0)));
+    pool.parallelFor(chunks.count, [&](std::size_t chunk) {
+        Bits any = 0;
+        Bits all = static_cast<Bits>(~Bits(0));
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i) {
+            Bits bits = radixBits(keyOf(data[i]));
+            any |= bits;
+            all &= bits;
+        }
+        anySet[chunk] = any;
+        allSet[chunk] = all;
+    });
+    Bits any = 0;
+    Bits all = static_cast<Bits>(~Bits(0));
+    for (std::size_t chunk = 0; chunk < chunks.count; ++chunk) {
+        any |= anySet[chunk];
+        all &= allSet[chunk];
+    }
+    return static_cast<Bits>(any ^ all);
+}
+
+// LSD passes over the bytes of data[0, n) below byteLimit that are set in
+// varying, with scratch of the same size. Returns data or scratch,
+// whichever holds the result.
+template <typename T, typename KeyOf, typename Bits>
+T* radixSortLsd(ThreadPool& pool, T* data, T* scratch, std::size_t n, std::size_t byteLimit, Bits varying,
+                KeyOf keyOf) {
+    RadixChunks chunks = radixChunks(pool, n);
+    for (std::size_t pass = 0; pass < byteLimit; ++pass) {
+        if (((varying >> (8 * pass)) & 0xff) == 0) {
+            continue; // Every key has the same byte here
+        }
+        radixScatter(pool, chunks, data, scratch, [&](const T& value) {
+            return static_cast<std::size_t>((radixBits(keyOf(value)) >> (8 * pass)) & 0xff);
+        });
+        std::swap(data, scratch);
+    }
+    return data;
+}
+
+// An MSD bucket holding more than 1/kRadixMsdMaxBucketShare of the whole input
+// is split again on the next byte with the whole pool, not left to one thread
+inline constexpr std::size_t kRadixMsdMaxBucketShare = 16;
+
+// Bytes up to the highest one set in varying
+template <typename Bits>
+std::size_t radixVaryingBytes(Bits varying) {
+    std::size_t bytes = 0;
+    while (bytes < sizeof(varying) && (varying >> (8 * bytes)) != 0) {
+        ++bytes;
+    }
+    return bytes;
+}
+
+template <typename T>
+void radixCopy(ThreadPool& pool, const T* source, std::size_t n, T* target) {
+    RadixChunks chunks = radixChunks(pool, n);
+    pool.parallelFor(chunks.count, [&](std::size_t chunk) {
+        std::copy(source + chunks.begin(chunk), source + chunks.end(chunk), target + chunks.begin(chunk));
+    });
+}
+
+// Large inputs with three or more bytes to sort split on the highest one
+// first (MSD); each bucket is then sorted by the lower bytes on one thread,
+// where its passes stay in cache instead of streaming through memory once
+// per byte. Skewed keys can leave most of the input in one or two buckets,
+// which would then run serially, so buckets of more than `largest` elements
+// are split again with every thread. Only the low `bytes` bytes of
+// data[0, n) may differ; the result ends up in data.
+template <typename T, typename KeyOf>
+void radixSortMsd(ThreadPool& pool, T* data, T* scratch, std::size_t n, std::size_t bytes, std::size_t largest,
+                  KeyOf keyOf) {
+    std::size_t msd = bytes - 1;
+    std::array<std::size_t, 256> starts = radixScatter(pool, radixChunks(pool, n), data, scratch,
+                                                       [&](const T& value) {
+        return static_cast<std::size_t>((radixBits(keyOf(value)) >> (8 * msd)) & 0xff);
+    });
+    auto bucketSize = [&](std::size_t bucket) { return (bucket + 1 < 256 ? starts[bucket + 1] : n) - starts[bucket]; };
+
+    pool.parallelFor(256, [&](std::size_t bucket) {
+        std::size_t begin = starts[bucket];
+        std::size_t size = bucketSize(bucket);
+        if (size > largest) {
+            return; // Split again below
+        }
+        T* split = scratch + begin;
+        T* result = split;
+        if (size < kRadixSortMinimum) {
+            std::stable_sort(split, split + size, [&](const T& a, const T& b) {
+                return radixBits(keyOf(a)) < radixBits(keyOf(b));
+            });
+        } else {
+            ThreadPool serial(1);
+            result = radixSortLsd(serial, split, data + begin, size, msd,
+                                  radixVaryingBits(serial, split, size, keyOf), keyOf);
+        }
+        if (result != data + begin) {
+            std::copy(result, result + size, data + begin);
+        }
+    });
+
+    for (std::size_t bucket = 0; bucket < 256; ++bucket) {
+        std::size_t begin = starts[bucket];
+        std::size_t size = bucketSize(bucket);
+        if (size <= largest) {
+            continue;
+        }
+        T* split = scratch + begin;
+        T* result = split;
+        auto varying = radixVaryingBits(pool, split, size, keyOf);
+        std::size_t rest = radixVaryingBytes(varying); // At most msd: higher bytes are equal here
+        if (rest < 3 || size < kRadixSortMinimum * 256) {
+            result = radixSortLsd(pool, split, data + begin, size, rest, varying, keyOf);
+        } else {
+            radixSortMsd(pool, split, data + begin, size, rest, largest, keyOf);
+        }
+        if (result != data + begin) {
+            radixCopy(pool, result, size, data + begin);
+        }
+    }
+}
+
+template <typename T, typename KeyOf>
+void radixSort(ThreadPool& pool, T* data, std::size_t n, KeyOf keyOf) {
+    std::vector<T> scratch(n);
+    auto varying = radixVaryingBits(pool, data, n, keyOf);
+    std::size_t bytes = radixVaryingBytes(varying);
+    if (bytes < 3 || n < kRadixSortMinimum * 256) {
+        T* sorted = radixSortLsd(pool, data, scratch.data(), n, bytes, varying, keyOf);
+        if (sorted != data) {
+            radixCopy(pool, sorted, n, data);
+        }
+    } else {
+        radixSortMsd(pool, data, scratch.data(), n, bytes, n / kRadixMsdMaxBucketShare, keyOf);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Stable LSD radix sort of a contiguous range, in parallel.
+ *
+ * Sorts by keyOf(element), which must yield an integer or floating-point
+ * key of up to 64 bits; the default sorts the elements themselves. For
+ * key-value pairs pass e.g. [](const auto& p) { return p.first; }.
+ *
+ * Each pass sorts one byte of the key. The threads histogram their own
+ * contiguous chunk of the input, a prefix sum over (byte, chunk) gives each
+ * thread its own output ranges, and each thread scatters its chunk through
+ * a small staging buffer per byte value, written out a cache line pair at a
+ * time. Passes over bytes that every key shares are skipped, so int64 keys
+ * below 2^24 take three passes, not eight. Floats sort as by operator<,
+ * except that -0.0 precedes +0.0 and NaNs go to the ends.
+ *
+ * Needs n elements of scratch memory. Ranges under kRadixSortMinimum use
+ * std::stable_sort instead.
+ */
+template <typename RandomIt, typename KeyOf = detail::RadixIdentity>
+void radixSort(ThreadPool& pool, RandomIt first, RandomIt last, KeyOf keyOf = {}) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = std::decay_t<decltype(keyOf(*first))>;
+    static_assert(detail::kRadixSortable<Key>, "radixSort keys must be integers or floating point");
+    std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < kRadixSortMinimum) {
+        std::stable_sort(first, last, [&](const T& a, const T& b) {
+            return detail::radixBits(keyOf(a)) < detail::radixBits(keyOf(b));
+        });
+        return;
+    }
+    detail::radixSort(pool, &*first, n, keyOf);
+}
+
+/// Single-threaded radixSort.
+template <typename RandomIt, typename KeyOf = detail::RadixIdentity>
+void radixSort(RandomIt first, RandomIt last, KeyOf keyOf = {}) {
+    ThreadPool pool(1);
+    radixSort(pool, first, last, keyOf);
+}
+
+/// Sorts keys for building an index: radixSort for numbers, std::sort otherwise.
+template <typename RandomIt>
+void sortKeys(ThreadPool& pool, RandomIt first, RandomIt last) {
+    if constexpr (detail::kRadixSortable<typename std::iterator_traits<RandomIt>::value_type>) {
+        radixSort(pool, first, last);
+    } else {
+        std::sort(first, last);
+    }
+}
+
+} // namespace search
+
+#endif // RADIX_SORT_HPP
@@ -0,0 +1,584 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <cmath> // For std::sqrt
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // For std::memcpy
+#include <functional> // For std::less, std::hash
+#include <new> // For std::align_val_t
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "simd_scan.hpp"
+
+/**
+ * @brief Header-only search routines over sorted ranges.
+ *
+ * Generalises binarySearch from p1.cpp: any key type, any strict weak
+ * ordering, and either an iterator pair (results are iterators) or a whole
+ * range such as std::vector, std::array or std::span (results are size_t
+ * indices, so arrays beyond 2^31 elements work).
+ */
+namespace search {
+
+/// Returned by binarySearch on a range when the key is not present.
+inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+/// Number of queries whose searches are interleaved by the batch kernels.
+inline constexpr std::size_t kBatchGroup = 16;
+
+/**
+ * @brief Kernel selectors, passed as an optional first argument.
+ *
+ * search::lowerBound(search::branchless, keys, 42) picks the branchless
+ * kernel; leaving the selector out is the same as passing search::classic.
+ * search::interpolation only applies to arithmetic keys in ascending order.
+ * search::simd finishes a branchless search with a vectorized scan;
+ * Simd{SimdLevel::Sse} and so on cap the instruction set it may use.
+ */
+struct Classic {};
+struct Branchless {};
+struct Interpolation {};
+struct Simd {
+    SimdLevel level = SimdLevel::Avx512; // The best the CPU has, up to this
+};
+
+inline constexpr Classic classic{};
+inline constexpr Branchless branchless{};
+inline constexpr Interpolation interpolation{};
+inline constexpr Simd simd{};
+
+namespace detail {
+
+template <typename T, typename = void>
+struct IsRange : std::false_type {};
+
+template <typename T>
+struct IsRange<T, std::void_t<decltype(std::begin(std::declval<const T&>())),
+                              decltype(std::end(std::declval<const T&>()))>> : std::true_type {};
+
+template <typename Range>
+using EnableIfRange = std::enable_if_t<IsRange<std::remove_reference_t<Range>>::value, int>;
+
+// Kernels usable with the policy-first overloads below
+template <typename T> struct IsPolicy : std::false_type {};
+template <> struct IsPolicy<Classic> : std::true_type {};
+template <> struct IsPolicy<Branchless> : std::true_type {};
+template <> struct IsPolicy<Interpolation> : std::true_type {};
+template <> struct IsPolicy<Simd> : std::true_type {};
+
+template <typename Policy, typename Range>
+using EnableIfPolicyRange = std::enable_if_t<IsPolicy<Policy>::value &&
+                                             IsRange<std::remove_reference_t<Range>>::value, int>;
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+// Prefetches an address computed from an index that may lie past the end of
+// an array; the hardware ignores prefetches of unmapped memory.
+template <typename T>
+void prefetchElement(const T* base, std::size_t index) {
+    prefetch(reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(base) + index * sizeof(T)));
+}
+
+inline int countTrailingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : __builtin_ctzll(value);
+#else
+    int count = 0;
+    while (count < 64 && !(value & 1)) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// floor(log2(value)) for value > 0
+inline int floorLog2(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int log = 0;
+    while (value >>= 1) {
+        ++log;
+    }
+    return log;
+#endif
+}
+
+// Final mixer of MurmurHash3: every input bit affects every output bit
+inline std::uint64_t mixHash64(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// 64-bit hash of a key: integers and floats by value (+0.0 and -0.0 alike),
+// anything else through std::hash
+template <typename Key>
+std::uint64_t hashKey(const Key& key) {
+    if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+        return mixHash64(static_cast<std::uint64_t>(key));
+    } else if constexpr (std::is_floating_point_v<Key>) {
+        double value = key == 0 ? 0.0 : static_cast<double>(key);
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return mixHash64(bits);
+    } else {
+        return mixHash64(static_cast<std::uint64_t>(std::hash<Key>{}(key)));
+    }
+}
+
+// Whether hashKey accepts Key (std::hash is not default constructible for
+// types it has no specialization for)
+template <typename Key>
+inline constexpr bool kHashable =
+    std::is_arithmetic_v<Key> || std::is_enum_v<Key> || std::is_default_constructible_v<std::hash<Key>>;
+
+/// Allocator returning cache-line aligned storage for search layouts
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* memory, std::size_t) noexcept {
+        ::operator delete(memory, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+// Iterator interface
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Finds the first element that is not ordered before key.
+ *
+ * @param first, last A sorted random-access range.
+ * @param key The value to search for.
+ * @param comp Strict weak ordering used to sort the range.
+ * @return Iterator to the first element e with !comp(e, key), or last.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt lowerBound(RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    auto count = last - first;
+    while (count > 0) {
+        auto half = count / 2;
+        RandomIt mid = first + half;
+        if (comp(*mid, key)) {
+            first = mid + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Finds the first element that is ordered after key.
+ *
+ * @return Iterator to the first element e with comp(key, e), or last.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt upperBound(RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    auto count = last - first;
+    while (count > 0) {
+        auto half = count / 2;
+        RandomIt mid = first + half;
+        if (!comp(key, *mid)) {
+            first = mid + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Finds the sub-range of elements equivalent to key.
+ *
+ * @return The pair (lowerBound, upperBound).
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+std::pair<RandomIt, RandomIt> equalRange(RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    RandomIt lower = search::lowerBound(first, last, key, comp);
+    return {lower, search::upperBound(lower, last, key, comp)};
+}
+
+/**
+ * @brief Classic three-way binary search, as in p1.cpp.
+ *
+ * Stops as soon as an equivalent element is seen, so with duplicate keys
+ * the returned element is any one of them.
+ *
+ * @return Iterator to an element equivalent to key, or last if none.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt binarySearch(RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    RandomIt low = first;
+    RandomIt high = last; // One past the end, unlike p1.cpp's inclusive bound
+    while (low < high) {
+        RandomIt mid = low + (high - low) / 2;
+        if (comp(*mid, key)) {
+            low = mid + 1;
+        } else if (comp(key, *mid)) {
+            high = mid;
+        } else {
+            return mid;
+        }
+    }
+    return last;
+}
+
+//-----------------------------------------------------------------------------
+// Kernel-selecting iterator interface
+//-----------------------------------------------------------------------------
+
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt lowerBound(Classic, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    return search::lowerBound(first, last, key, comp);
+}
+
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt upperBound(Classic, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    return search::upperBound(first, last, key, comp);
+}
+
+/**
+ * @brief Branchless lower bound.
+ *
+ * The loop runs exactly ceil(log2(n)) times whatever the key, and the only
+ * data-dependent step is a select between two pointers, which compilers
+ * turn into a conditional move. Both possible next probes are prefetched,
+ * which helps once the array no longer fits in cache.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt lowerBound(Branchless, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    auto length = last - first;
+    if (length == 0) {
+        return first;
+    }
+    RandomIt base = first;
+    while (length > 1) {
+        auto half = length / 2;
+        detail::prefetch(&base[half / 2]);
+        detail::prefetch(&base[half + half / 2]);
+        base = comp(base[half], key) ? base + half : base;
+        length -= half;
+    }
+    return base + (comp(*base, key) ? 1 : 0);
+}
+
+/// Branchless counterpart of upperBound; see lowerBound(Branchless, ...).
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt upperBound(Branchless, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    auto length = last - first;
+    if (length == 0) {
+        return first;
+    }
+    RandomIt base = first;
+    while (length > 1) {
+        auto half = length / 2;
+        detail::prefetch(&base[half / 2]);
+        detail::prefetch(&base[half + half / 2]);
+        base = comp(key, base[half]) ? base : base + half;
+        length -= half;
+    }
+    return base + (comp(key, *base) ? 0 : 1);
+}
+
+namespace detail {
+
+// Iterators over contiguous storage, whose elements the vector kernels can load
+template <typename It, typename T = typename std::iterator_traits<It>::value_type>
+inline constexpr bool kContiguousIterator =
+    std::is_pointer_v<It> || std::is_same_v<It, typename std::vector<T>::iterator> ||
+    std::is_same_v<It, typename std::vector<T>::const_iterator> ||
+    std::is_same_v<It, typename std::vector<T, AlignedAllocator<T>>::iterator> ||
+    std::is_same_v<It, typename std::vector<T, AlignedAllocator<T>>::const_iterator>;
+
+// Probe keys that compare with T exactly as they would once converted to T
+template <typename Key, typename T>
+inline constexpr bool kSimdKey =
+    std::is_same_v<Key, T> ||
+    (std::is_integral_v<Key> && std::is_integral_v<T> && !std::is_same_v<Key, bool> &&
+     std::is_signed_v<Key> == std::is_signed_v<T> && sizeof(Key) <= sizeof(T)) ||
+    (std::is_same_v<Key, float> && std::is_same_v<T, double>);
+
+template <typename RandomIt, typename Key, typename Compare,
+          typename T = typename std::iterator_traits<RandomIt>::value_type>
+inline constexpr bool kSimdSearchable =
+    kSimdScannable<T> && kContiguousIterator<RandomIt> && kSimdKey<std::decay_t<Key>, T> &&
+    (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+
+// The vector scan's window: two cache lines
+inline constexpr std::size_t kSimdWindowBytes = 128;
+
+// Lower (upper, when OrEqual) bound of key in data[0, n). Branchless halving
+// narrows the answer to a window of at most kSimdWindowBytes; that window is
+// then widened to exactly kSimdWindowBytes, staying inside the array, and
+// its elements below key counted. Widening only adds elements on the far
+// side of the answer, or ones already known to be below key, so
+// (window start + count) is still the bound, and the scan length is fixed.
+template <bool OrEqual, typename T>
+std::size_t simdBound(SimdLevel level, const T* data, std::size_t n, T key) {
+    constexpr std::size_t kWindow = kSimdWindowBytes / sizeof(T);
+    if (n <= kWindow) {
+        return countBelow<OrEqual>(level, data, n, key);
+    }
+    const T* base = data;
+    std::size_t length = n;
+    while (length > kWindow) {
+        std::size_t half = length / 2;
+        prefetch(&base[half / 2]);
+        prefetch(&base[half + half / 2]);
+        base = (OrEqual ? !(key < base[half]) : base[half] < key) ? base + half : base;
+        length -= half;
+    }
+    const T* start = base < data + (n - kWindow) ? base : data + (n - kWindow);
+    return static_cast<std::size_t>(start - data) + countBelow<OrEqual>(level, start, kWindow, key);
+}
+
+} // namespace detail
+
+/**
+ * @brief Lower bound finished by a vectorized linear scan.
+ *
+ * Ranges of up to 128 bytes (32 int32 or 16 int64 keys) are scanned whole,
+ * a register of 4-16 keys per compare. Longer ranges are first narrowed by
+ * branchless halving to a 128-byte window, which replaces the last four or
+ * five dependent halving steps with independent compares of two cache
+ * lines. That mostly shortens the latency of a lookup; throughput over
+ * many independent lookups is about the same as lowerBound(Branchless, ...).
+ *
+ * The kernel (AVX-512, AVX2, SSE4.2 or scalar) is picked at run time from
+ * what the CPU supports, capped by policy.level. Applies to 32- and 64-bit
+ * integer and floating-point keys in contiguous storage under the default
+ * ordering; anything else runs lowerBound(Branchless, ...).
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt lowerBound(Simd policy, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    if constexpr (detail::kSimdSearchable<RandomIt, Key, Compare>) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        std::size_t n = static_cast<std::size_t>(last - first);
+        return n == 0 ? first : first + detail::simdBound<false>(policy.level, &*first, n, static_cast<T>(key));
+    } else {
+        return search::lowerBound(Branchless{}, first, last, key, comp);
+    }
+}
+
+/// Vectorized counterpart of upperBound; see lowerBound(Simd, ...).
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt upperBound(Simd policy, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    if constexpr (detail::kSimdSearchable<RandomIt, Key, Compare>) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        std::size_t n = static_cast<std::size_t>(last - first);
+        return n == 0 ? first : first + detail::simdBound<true>(policy.level, &*first, n, static_cast<T>(key));
+    } else {
+        return search::upperBound(Branchless{}, first, last, key, comp);
+    }
+}
+
+namespace detail {
+
+// Windows this small are finished with a binary search
+inline constexpr std::ptrdiff_t kInterpolationMinWindow = 16;
+// Guard jumps of sqrt(window) tried after each interpolated probe
+inline constexpr int kInterpolationJumps = 2;
+
+// First element e of [first, last) with !before(e), where before holds for a
+// prefix of the range. Each round probes where key would sit if the values
+// were evenly spread, then jumps sqrt(window) at a time to bracket the answer.
+// On uniform keys the first jump usually brackets it, giving O(log log n)
+// probes. If kInterpolationJumps jumps do not, the values are skewed, and
+// the rest of the window is finished with the branchless binary search, so
+// the worst case stays O(log n).
+template <typename RandomIt, typename Key, typename Before>
+RandomIt interpolationSearch(RandomIt first, RandomIt last, const Key& key, Before before) {
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(std::is_arithmetic_v<Value> && std::is_arithmetic_v<Key>,
+                  "interpolation search needs arithmetic keys");
+    std::ptrdiff_t low = 0;
+    std::ptrdiff_t high = last - first; // The answer lies in [low, high]
+    auto binaryFinish = [&] {
+        auto predicate = [&](const auto& element, const Key&) { return before(element); };
+        return search::lowerBound(Branchless{}, first + low, first + high, key, predicate);
+    };
+    while (high - low > kInterpolationMinWindow) {
+        std::ptrdiff_t width = high - low;
+        double lowValue = static_cast<double>(first[low]);
+        double highValue = static_cast<double>(first[high - 1]);
+        double fraction = highValue > lowValue ? (static_cast<double>(key) - lowValue) / (highValue - lowValue) : 0;
+        fraction = fraction > 0 ? (fraction < 1 ? fraction : 1) : 0;
+        std::ptrdiff_t probe = low + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(width - 1));
+        std::ptrdiff_t step = static_cast<std::ptrdiff_t>(std::sqrt(static_cast<double>(width)));
+
+        bool bracketed = false;
+        if (before(first[probe])) {
+            low = probe + 1;
+            for (int jump = 0; jump < kInterpolationJumps && !bracketed && low + step < high; ++jump) {
+                if (before(first[low + step])) {
+                    low += step + 1;
+                } else {
+                    high = low + step;
+                    bracketed = true;
+                }
+            }
+        } else {
+            high = probe;
+            for (int jump = 0; jump < kInterpolationJumps && !bracketed && high - step > low; ++jump) {
+                if (before(first[high - step - 1])) {
+                    low = high - step;
+                    bracketed = true;
+                } else {
+                    high -= step + 1;
+                }
+            }
+        }
+        if (!bracketed && high - low > width / 2) {
+            return binaryFinish();
+        }
+    }
+    return binaryFinish();
+}
+
+} // namespace detail
+
+/**
+ * @brief Interpolation lower bound for arithmetic keys.
+ *
+ * Probes where the key's value falls between the window's end values rather
+ * than at the midpoint, with sqrt-sized guard jumps and a binary fallback
+ * for skewed data (see detail::interpolationSearch). comp must order the
+ * keys by numeric value, as std::less<> does.
+ */
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt lowerBound(Interpolation, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    return detail::interpolationSearch(first, last, key, [&](const auto& element) { return comp(element, key); });
+}
+
+/// Interpolation counterpart of upperBound; see lowerBound(Interpolation, ...).
+template <typename RandomIt, typename Key, typename Compare = std::less<>>
+RandomIt upperBound(Interpolation, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    return detail::interpolationSearch(first, last, key, [&](const auto& element) { return !comp(key, element); });
+}
+
+template <typename Policy, typename RandomIt, typename Key, typename Compare = std::less<>,
+          std::enable_if_t<detail::IsPolicy<Policy>::value, int> = 0>
+std::pair<RandomIt, RandomIt> equalRange(Policy policy, RandomIt first, RandomIt last, const Key& key,
+                                         Compare comp = {}) {
+    RandomIt lower = search::lowerBound(policy, first, last, key, comp);
+    return {lower, search::upperBound(policy, lower, last, key, comp)};
+}
+
+/// Finds an element equivalent to key with the selected kernel, or returns last.
+template <typename Policy, typename RandomIt, typename Key, typename Compare = std::less<>,
+          std::enable_if_t<detail::IsPolicy<Policy>::value, int> = 0>
+RandomIt binarySearch(Policy policy, RandomIt first, RandomIt last, const Key& key, Compare comp = {}) {
+    if constexpr (std::is_same_v<Policy, Classic>) {
+        return search::binarySearch(first, last, key, comp);
+    } else {
+        RandomIt found = search::lowerBound(policy, first, last, key, comp);
+        return (found != last && !comp(key, *found)) ? found : last;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Range interface (results are indices)
+//-----------------------------------------------------------------------------
+
+template <typename Range, typename Key, typename Compare = std::less<>, detail::EnableIfRange<Range> = 0>
+std::size_t lowerBound(const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    return static_cast<std::size_t>(search::lowerBound(first, std::end(range), key, comp) - first);
+}
+
+template <typename Range, typename Key, typename Compare = std::less<>, detail::EnableIfRange<Range> = 0>
+std::size_t upperBound(const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    return static_cast<std::size_t>(search::upperBound(first, std::end(range), key, comp) - first);
+}
+
+template <typename Range, typename Key, typename Compare = std::less<>, detail::EnableIfRange<Range> = 0>
+std::pair<std::size_t, std::size_t> equalRange(const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    auto found = search::equalRange(first, std::end(range), key, comp);
+    return {static_cast<std::size_t>(found.first - first), static_cast<std::size_t>(found.second - first)};
+}
+
+/**
+ * @brief Index-returning form of binarySearch.
+ *
+ * @return The index of an element equivalent to key, or search::npos.
+ */
+template <typename Range, typename Key, typename Compare = std::less<>, detail::EnableIfRange<Range> = 0>
+std::size_t binarySearch(const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    auto last = std::end(range);
+    auto found = search::binarySearch(first, last, key, comp);
+    return found == last ? npos : static_cast<std::size_t>(found - first);
+}
+
+template <typename Policy, typename Range, typename Key, typename Compare = std::less<>,
+          detail::EnableIfPolicyRange<Policy, Range> = 0>
+std::size_t lowerBound(Policy policy, const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    return static_cast<std::size_t>(search::lowerBound(policy, first, std::end(range), key, comp) - first);
+}
+
+template <typename Policy, typename Range, typename Key, typename Compare = std::less<>,
+          detail::EnableIfPolicyRange<Policy, Range> = 0>
+std::size_t upperBound(Policy policy, const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    return static_cast<std::size_t>(search::upperBound(policy, first, std::end(range), key, comp) - first);
+}
+
+template <typename Policy, typename Range, typename Key, typename Compare = std::less<>,
+          detail::EnableIfPolicyRange<Policy, Range> = 0>
+std::pair<std::size_t, std::size_t> equalRange(Policy policy, const Range& range, const Key& key,
+                                               Compare comp = {}) {
+    auto first = std::begin(range);
+    auto found = search::equalRange(policy, first, std::end(range), key, comp);
+    return {static_cast<std::size_t>(found.first - first), static_cast<std::size_t>(found.second - first)};
+}
+
+template <typename Policy, typename Range, typename Key, typename Compare = std::less<>,
+          detail::EnableIfPolicyRange<Policy, Range> = 0>
+std::size_t binarySearch(Policy policy, const Range& range, const Key& key, Compare comp = {}) {
+    auto first = std::begin(range);
+    auto last = std::end(range);
+    auto found = search::binarySearch(policy, first, last, key, comp);
+    return found == last ? npos : static_cast<std::size_t>(found - first);
+}
+
+} // namespace search
+
+#endif // SEARCH_HPP
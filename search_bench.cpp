@@ -0,0 +1,1450 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include "search.hpp"
+#include "eytzinger.hpp"
+#include "stree.hpp"
+#include "batch_search.hpp"
+#include "parallel_search.hpp"
+#include "learned_index.hpp"
+#include "search_index.hpp"
+#include "mapped_keys.hpp"
+#include "packed_keys.hpp"
+#include "elias_fano.hpp"
+#include "dynamic_set.hpp"
+#include "veb_tree.hpp"
+#include "snapshot_index.hpp"
+#include "radix_sort.hpp"
+#include "bloom_filter.hpp"
+
+#if SEARCH_HAS_MMAP
+#include <sys/resource.h>
+#endif
+#if defined(SEARCH_BENCH_PSTL)
+#include <execution>
+#endif
+
+// Benchmarks for the search kernels in search.hpp.
+//
+// Build: g++ -std=c++17 -O2 -march=native -pthread search_bench.cpp -o search_bench
+// (add -DSEARCH_BENCH_PSTL -ltbb to compare std::execution::par sort too)
+// Usage: search_bench [suite|all] [max_elements]
+//
+// Each row reports the average time per lookup over a stream of random
+// queries, half of which hit and half of which miss. Every kernel's answers
+// are checked against std on a sample of its queries before it is timed.
+
+//-----------------------------------------------------------------------------
+// Benchmark Helpers
+//-----------------------------------------------------------------------------
+
+// Fixed-width string key, compared bytewise like a memcmp-sorted key file
+template <std::size_t N>
+struct FixedKey {
+    std::array<char, N> bytes{};
+
+    friend bool operator<(const FixedKey& a, const FixedKey& b) {
+        return std::memcmp(a.bytes.data(), b.bytes.data(), N) < 0;
+    }
+};
+
+template <typename T>
+T keyFromNumber(std::uint64_t value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(value) * T(0.5);
+    } else if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(value);
+    } else {
+        // Big-endian bytes so memcmp order (unsigned bytes) matches numeric order
+        T key;
+        for (std::size_t i = 0; i < key.bytes.size(); ++i) {
+            std::size_t shift = 8 * (key.bytes.size() - 1 - i);
+            key.bytes[i] = shift < 64 ? static_cast<char>(static_cast<unsigned char>((value >> shift) & 0xff)) : 0;
+        }
+        return key;
+    }
+}
+
+// Sorted, distinct keys with gaps so that every other value is a miss
+template <typename T>
+std::vector<T> makeSortedKeys(std::size_t count) {
+    std::vector<T> keys(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = keyFromNumber<T>(2 * i + 1);
+    }
+    return keys;
+}
+
+// Sorted timestamps: random gaps averaging 100 with occasional bursts of
+// near-identical stamps, close to linear overall like real event logs
+template <typename T>
+std::vector<T> makeTimestampKeys(std::size_t count, std::mt19937_64& rng) {
+    std::uniform_int_distribution<std::uint64_t> gap(1, 199);
+    std::uniform_int_distribution<int> burst(0, 99);
+    std::vector<T> keys(count);
+    std::uint64_t now = 1000;
+    for (std::size_t i = 0; i < count; ++i) {
+        now += burst(rng) == 0 ? 1 : gap(rng);
+        keys[i] = static_cast<T>(now);
+    }
+    return keys;
+}
+
+// Sorted int64 keys with the named distribution: "uniform" over [0, 2^40),
+// "zipfian" with a power-law tail (most keys small, a few huge), or
+// "clustered" in 64 dense runs spread far apart
+std::vector<std::int64_t> makeDistributedKeys(const std::string& distribution, std::size_t count,
+                                              std::mt19937_64& rng) {
+    std::vector<std::int64_t> keys(count);
+    std::uniform_real_distribution<double> unit(1e-9, 1.0);
+    std::uniform_int_distribution<std::int64_t> wide(0, std::int64_t(1) << 40);
+    std::vector<std::int64_t> clusterStart(64);
+    for (auto& start : clusterStart) {
+        start = wide(rng);
+    }
+    for (auto& key : keys) {
+        if (distribution == "zipfian") {
+            key = static_cast<std::int64_t>(1000.0 / unit(rng));
+        } else if (distribution == "clustered") {
+            key = clusterStart[rng() % clusterStart.size()] + static_cast<std::int64_t>(rng() % (4 * count));
+        } else {
+            key = wide(rng);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+template <typename T>
+std::vector<T> makeQueries(std::size_t keyCount, std::size_t queryCount, std::mt19937_64& rng) {
+    std::uniform_int_distribution<std::uint64_t> pick(0, 2 * keyCount);
+    std::vector<T> queries(queryCount);
+    for (auto& query : queries) {
+        query = keyFromNumber<T>(pick(rng));
+    }
+    return queries;
+}
+
+// Keeps results alive so the compiler can't drop the lookups
+volatile std::size_t benchmarkSink = 0;
+
+// Runs lookup(query) for every query and returns nanoseconds per lookup
+template <typename Query, typename Lookup>
+double nanosPerLookup(const std::vector<Query>& queries, Lookup lookup) {
+    std::size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Query& query : queries) {
+        checksum += lookup(query);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    benchmarkSink = benchmarkSink + checksum;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / queries.size();
+}
+
+void printHeader(const std::string& title) {
+    std::cout << "\n== " << title << " ==" << std::endl;
+    std::cout << std::left << std::setw(12) << "elements" << std::setw(28) << "kernel"
+              << std::right << std::setw(12) << "ns/lookup" << std::setw(14) << "Mlookups/s" << std::endl;
+}
+
+// Wall-clock seconds taken by fn()
+template <typename Fn>
+double secondsFor(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRow(std::size_t elements, const std::string& kernel, double nanos) {
+    std::cout << std::left << std::setw(12) << elements << std::setw(28) << kernel
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << nanos
+              << std::setw(14) << 1000.0 / nanos << std::endl;
+}
+
+// Array sizes from L1-resident up to maxElements, growing 8x per step
+std::vector<std::size_t> sizesUpTo(std::size_t maxElements) {
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 1024; n <= maxElements; n *= 8) {
+        sizes.push_back(n);
+    }
+    return sizes;
+}
+
+// Each kernel is checked against std on a sample of its queries before it
+// is timed, and the run stops at the first wrong answer: a fast kernel
+// that searches the wrong thing must not produce a row.
+constexpr std::size_t kCheckedQueries = 4096;
+
+[[noreturn]] void failCheck(const std::string& message) {
+    std::cerr << "CHECK FAILED: " << message << std::endl;
+    std::exit(1);
+}
+
+[[noreturn]] void failCheck(const std::string& what, std::size_t queryIndex, std::size_t got, std::size_t want) {
+    failCheck(what + " on query " + std::to_string(queryIndex) + " gave " + std::to_string(got) + ", std gives " +
+              std::to_string(want));
+}
+
+// Compares got(query) with want(query) on kCheckedQueries queries spread
+// evenly over the set
+template <typename Query, typename Got, typename Want>
+void checkLookups(const std::string& what, const std::vector<Query>& queries, Got got, Want want) {
+    std::size_t step = std::max<std::size_t>(1, queries.size() / kCheckedQueries);
+    for (std::size_t i = 0; i < queries.size(); i += step) {
+        std::size_t result = got(queries[i]);
+        std::size_t expected = want(queries[i]);
+        if (result != expected) {
+            failCheck(what, i, result, expected);
+        }
+    }
+}
+
+// Compares a batch kernel's output for all of queries with want(query),
+// on kCheckedQueries positions spread evenly over the batch
+template <typename Query, typename BatchFn, typename Want>
+void checkBatch(const std::string& what, const std::vector<Query>& queries, BatchFn batchFn, Want want) {
+    std::vector<std::size_t> results(queries.size());
+    batchFn(queries, results);
+    std::size_t step = std::max<std::size_t>(1, queries.size() / kCheckedQueries);
+    for (std::size_t i = 0; i < queries.size(); i += step) {
+        if (results[i] != want(queries[i])) {
+            failCheck(what, i, results[i], want(queries[i]));
+        }
+    }
+}
+
+template <typename T>
+std::size_t stdLowerBound(const std::vector<T>& keys, const T& q) {
+    return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+}
+
+template <typename T>
+std::size_t stdUpperBound(const std::vector<T>& keys, const T& q) {
+    return static_cast<std::size_t>(std::upper_bound(keys.begin(), keys.end(), q) - keys.begin());
+}
+
+// First position of q in keys, or search::npos
+template <typename T>
+std::size_t stdFind(const std::vector<T>& keys, const T& q) {
+    std::size_t position = stdLowerBound(keys, q);
+    return position < keys.size() && !(q < keys[position]) ? position : search::npos;
+}
+
+// A find() result made comparable with stdFind: kernels may return any of
+// several equal keys, so a hit maps to the first key equal to it
+template <typename T>
+std::size_t firstEqual(const std::vector<T>& keys, std::size_t found) {
+    return found < keys.size() ? stdLowerBound(keys, keys[found]) : found;
+}
+
+// std's answers only mean something over sorted keys
+template <typename T>
+void checkSorted(const std::string& what, const std::vector<T>& keys) {
+    auto unsorted = std::is_sorted_until(keys.begin(), keys.end());
+    if (unsorted != keys.end()) {
+        failCheck(what + ": keys out of order at element " + std::to_string(unsorted - keys.begin()));
+    }
+}
+
+// Checks an index's lowerBound, upperBound and find against std on keys
+template <typename Index, typename T>
+void checkIndex(const std::string& what, const Index& index, const std::vector<T>& keys,
+                const std::vector<T>& queries) {
+    checkSorted(what, keys);
+    checkLookups(what + " lowerBound", queries, [&](const T& q) { return index.lowerBound(q); },
+                 [&](const T& q) { return stdLowerBound(keys, q); });
+    checkLookups(what + " upperBound", queries, [&](const T& q) { return index.upperBound(q); },
+                 [&](const T& q) { return stdUpperBound(keys, q); });
+    checkLookups(what + " find", queries, [&](const T& q) { return firstEqual(keys, index.find(q)); },
+                 [&](const T& q) { return stdFind(keys, q); });
+}
+
+// The same for a kernel selector over the sorted array itself
+template <typename Policy, typename T>
+void checkPolicy(const std::string& what, Policy policy, const std::vector<T>& keys, const std::vector<T>& queries) {
+    checkSorted(what, keys);
+    checkLookups(what + " lowerBound", queries, [&](const T& q) { return search::lowerBound(policy, keys, q); },
+                 [&](const T& q) { return stdLowerBound(keys, q); });
+    checkLookups(what + " upperBound", queries, [&](const T& q) { return search::upperBound(policy, keys, q); },
+                 [&](const T& q) { return stdUpperBound(keys, q); });
+    checkLookups(what + " binarySearch", queries,
+                 [&](const T& q) { return firstEqual(keys, search::binarySearch(policy, keys, q)); },
+                 [&](const T& q) { return stdFind(keys, q); });
+}
+
+//-----------------------------------------------------------------------------
+// Suites
+//-----------------------------------------------------------------------------
+
+// The loop from the original p1.cpp, kept verbatim as the baseline
+int referenceBinarySearch(const std::vector<int>& arr, int target) {
+    int low = 0;
+    int high = arr.size() - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (arr[mid] == target) {
+            return mid;
+        }
+        if (arr[mid] < target) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+constexpr std::size_t kQueryCount = 1 << 20;
+
+template <typename T>
+void benchKeyType(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng) {
+    printHeader("key type " + typeName);
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+        checkPolicy("search", search::classic, keys, queries);
+
+        if constexpr (std::is_same_v<T, int>) {
+            checkLookups("p1 binarySearch", queries, [&](int q) {
+                return firstEqual(keys, static_cast<std::size_t>(referenceBinarySearch(keys, q)));
+            }, [&](int q) { return stdFind(keys, q); });
+            printRow(n, "p1 binarySearch (int)", nanosPerLookup(queries, [&](int q) {
+                return static_cast<std::size_t>(referenceBinarySearch(keys, q));
+            }));
+        }
+        printRow(n, "search::binarySearch", nanosPerLookup(queries, [&](const T& q) {
+            return search::binarySearch(keys, q);
+        }));
+        printRow(n, "search::lowerBound", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(keys, q);
+        }));
+        printRow(n, "std::lower_bound", nanosPerLookup(queries, [&](const T& q) {
+            return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+        }));
+    }
+}
+
+void benchTypes(std::size_t maxElements, std::mt19937_64& rng) {
+    benchKeyType<int>("int32", maxElements, rng);
+    benchKeyType<std::uint64_t>("uint64", maxElements, rng);
+    benchKeyType<double>("double", maxElements, rng);
+    benchKeyType<FixedKey<16>>("fixed16", std::min<std::size_t>(maxElements, 1 << 22), rng);
+}
+
+// Classic vs branchless lower bound, L1-sized up to DRAM-sized arrays, with
+// random query streams and sorted ones (where branches predict well)
+template <typename T>
+void benchBranchlessFor(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng) {
+    for (bool sortedQueries : {false, true}) {
+        printHeader("lower bound, " + typeName + ", " + (sortedQueries ? "sorted" : "random") + " queries");
+        for (std::size_t n : sizesUpTo(maxElements)) {
+            std::vector<T> keys = makeSortedKeys<T>(n);
+            std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+            if (sortedQueries) {
+                std::sort(queries.begin(), queries.end());
+            }
+            checkPolicy("classic", search::classic, keys, queries);
+            checkPolicy("branchless", search::branchless, keys, queries);
+            printRow(n, "classic", nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::classic, keys, q);
+            }));
+            printRow(n, "branchless", nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::branchless, keys, q);
+            }));
+            printRow(n, "std::lower_bound", nanosPerLookup(queries, [&](const T& q) {
+                return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+            }));
+        }
+    }
+}
+
+void benchBranchless(std::size_t maxElements, std::mt19937_64& rng) {
+    benchBranchlessFor<int>("int32", maxElements, rng);
+    benchBranchlessFor<std::uint64_t>("uint64", maxElements, rng);
+}
+
+// Lower bound on the sorted array against the index layouts built from it.
+// The S-tree uses AVX2 when built with -mavx2/-march=native, scalar otherwise.
+template <typename T>
+void benchLayoutsFor(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng) {
+    printHeader("layouts, " + typeName + ", random queries");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+        checkPolicy("branchless", search::branchless, keys, queries);
+
+        printRow(n, "std::lower_bound", nanosPerLookup(queries, [&](const T& q) {
+            return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+        }));
+        printRow(n, "branchless", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+
+        search::EytzingerIndex<T> eytzinger;
+        double build = secondsFor([&] { eytzinger = search::EytzingerIndex<T>(keys); });
+        checkIndex("eytzinger", eytzinger, keys, queries);
+        printRow(n, "eytzinger (build " + std::to_string(static_cast<long>(build * 1000)) + " ms)",
+                 nanosPerLookup(queries, [&](const T& q) { return eytzinger.lowerBound(q); }));
+
+        search::STree<T> stree;
+        build = secondsFor([&] { stree = search::STree<T>(keys); });
+        checkIndex("s-tree", stree, keys, queries);
+        printRow(n, "s-tree (build " + std::to_string(static_cast<long>(build * 1000)) + " ms)",
+                 nanosPerLookup(queries, [&](const T& q) { return stree.lowerBound(q); }));
+    }
+}
+
+void benchLayouts(std::size_t maxElements, std::mt19937_64& rng) {
+    benchLayoutsFor<int>("int32", maxElements, rng);
+    benchLayoutsFor<std::int64_t>("int64", maxElements, rng);
+}
+
+// Nanoseconds per query for resolving a whole batch with batchFn(queries, results)
+template <typename Query, typename BatchFn>
+double nanosPerBatchLookup(const std::vector<Query>& queries, BatchFn batchFn) {
+    std::vector<std::size_t> results(queries.size());
+    double seconds = secondsFor([&] { batchFn(queries, results); });
+    std::size_t checksum = 0;
+    for (std::size_t result : results) {
+        checksum += result;
+    }
+    benchmarkSink = benchmarkSink + checksum;
+    return seconds * 1e9 / queries.size();
+}
+
+// One lookup at a time against the interleaved batch kernels, for batch
+// sizes from 1k to 1M queries
+void benchBatch(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = int;
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        search::EytzingerIndex<T> eytzinger(keys);
+        search::STree<T> stree(keys);
+
+        printHeader("batch lookups, int32, " + std::to_string(n) + " elements");
+        for (std::size_t batch = 1024; batch <= kQueryCount; batch *= 32) {
+            std::vector<T> queries = makeQueries<T>(n, batch, rng);
+            std::string suffix = " x" + std::to_string(batch);
+            auto want = [&](T q) { return stdLowerBound(keys, q); };
+            checkPolicy("branchless", search::branchless, keys, queries);
+            checkIndex("eytzinger", eytzinger, keys, queries);
+            checkIndex("s-tree", stree, keys, queries);
+            checkBatch("branchless batch", queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(search::branchless, keys.begin(), keys.end(), q.data(), q.size(), out.data());
+            }, want);
+            checkBatch("eytzinger batch", queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(eytzinger, q.data(), q.size(), out.data());
+            }, want);
+            checkBatch("s-tree batch", queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(stree, q.data(), q.size(), out.data());
+            }, want);
+
+            printRow(n, "branchless loop" + suffix, nanosPerLookup(queries, [&](T q) {
+                return search::lowerBound(search::branchless, keys, q);
+            }));
+            printRow(n, "branchless batch" + suffix, nanosPerBatchLookup(queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(search::branchless, keys.begin(), keys.end(), q.data(), q.size(), out.data());
+            }));
+            printRow(n, "eytzinger loop" + suffix, nanosPerLookup(queries, [&](T q) {
+                return eytzinger.lowerBound(q);
+            }));
+            printRow(n, "eytzinger batch" + suffix, nanosPerBatchLookup(queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(eytzinger, q.data(), q.size(), out.data());
+            }));
+            printRow(n, "s-tree loop" + suffix, nanosPerLookup(queries, [&](T q) {
+                return stree.lowerBound(q);
+            }));
+            printRow(n, "s-tree batch" + suffix, nanosPerBatchLookup(queries, [&](auto& q, auto& out) {
+                search::lowerBoundBatch(stree, q.data(), q.size(), out.data());
+            }));
+        }
+    }
+}
+
+const char* strategyName(search::BatchStrategy strategy) {
+    switch (strategy) {
+        case search::BatchStrategy::Independent: return "independent";
+        case search::BatchStrategy::Galloping:   return "galloping";
+        case search::BatchStrategy::Merge:       return "merge";
+        case search::BatchStrategy::Auto:        return "auto";
+    }
+    return "?";
+}
+
+// Independent vs galloping vs merge as the batch grows relative to the array
+void benchStrategies(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = int;
+    std::size_t n = sizesUpTo(maxElements).back();
+    std::vector<T> keys = makeSortedKeys<T>(n);
+    for (bool sortedQueries : {false, true}) {
+        printHeader(std::string("batch strategies, int32, ") + (sortedQueries ? "sorted" : "unsorted") +
+                    " queries (kernel column: strategy / array:batch ratio)");
+        for (std::size_t batch = std::max<std::size_t>(16, n / 16384); batch <= 4 * n; batch *= 8) {
+            std::vector<T> queries = makeQueries<T>(n, batch, rng);
+            if (sortedQueries) {
+                std::sort(queries.begin(), queries.end());
+            }
+            std::string ratio = batch <= n ? std::to_string(n / batch) + ":1" : "1:" + std::to_string(batch / n);
+            for (auto strategy : {search::BatchStrategy::Independent, search::BatchStrategy::Galloping,
+                                  search::BatchStrategy::Merge, search::BatchStrategy::Auto}) {
+                std::string label = std::string(strategyName(strategy)) + " " + ratio;
+                if (strategy == search::BatchStrategy::Auto) {
+                    label += std::string(" (") + strategyName(search::chooseBatchStrategy(n, batch, sortedQueries, sizeof(T))) + ")";
+                }
+                auto lookupAll = [&](auto& q, auto& out) {
+                    search::lowerBoundBatch(strategy, keys.begin(), keys.end(), q.data(), q.size(), out.data());
+                };
+                checkBatch(label, queries, lookupAll, [&](T q) { return stdLowerBound(keys, q); });
+                printRow(n, label, nanosPerBatchLookup(queries, lookupAll));
+            }
+        }
+    }
+}
+
+// Scaling of the batch kernels over 1 to 64 threads on one shared array
+void benchParallel(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = int;
+    std::size_t n = sizesUpTo(maxElements).back();
+    std::vector<T> keys = makeSortedKeys<T>(n);
+    search::EytzingerIndex<T> eytzinger(keys);
+    search::STree<T> stree(keys);
+    std::vector<T> queries = makeQueries<T>(n, 4 * kQueryCount, rng);
+
+    printHeader("parallel batch lookups, int32, " + std::to_string(queries.size()) + " queries (hardware threads: " +
+                std::to_string(std::thread::hardware_concurrency()) + ")");
+    auto want = [&](T q) { return stdLowerBound(keys, q); };
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        search::ThreadPool pool(threads);
+        std::string suffix = " t=" + std::to_string(threads);
+        auto branchlessAll = [&](auto& q, auto& out) {
+            search::parallelLowerBoundBatch(pool, search::branchless, keys.begin(), keys.end(), q.data(), q.size(),
+                                            out.data());
+        };
+        auto eytzingerAll = [&](auto& q, auto& out) {
+            search::parallelLowerBoundBatch(pool, eytzinger, q.data(), q.size(), out.data());
+        };
+        auto streeAll = [&](auto& q, auto& out) {
+            search::parallelLowerBoundBatch(pool, stree, q.data(), q.size(), out.data());
+        };
+        checkBatch("branchless" + suffix, queries, branchlessAll, want);
+        checkBatch("eytzinger" + suffix, queries, eytzingerAll, want);
+        checkBatch("s-tree" + suffix, queries, streeAll, want);
+        printRow(n, "branchless" + suffix, nanosPerBatchLookup(queries, branchlessAll));
+        printRow(n, "eytzinger" + suffix, nanosPerBatchLookup(queries, eytzingerAll));
+        printRow(n, "s-tree" + suffix, nanosPerBatchLookup(queries, streeAll));
+    }
+}
+
+// Learned index against the comparison searches, on linear and timestamp keys
+template <typename T>
+void benchLearnedOn(const std::string& dataName, const std::vector<T>& keys, std::mt19937_64& rng) {
+    std::uniform_int_distribution<std::uint64_t> pick(static_cast<std::uint64_t>(keys.front()),
+                                                      static_cast<std::uint64_t>(keys.back()));
+    std::vector<T> queries(kQueryCount);
+    for (auto& query : queries) {
+        query = static_cast<T>(pick(rng));
+    }
+    std::size_t n = keys.size();
+    checkPolicy(dataName + " classic", search::classic, keys, queries);
+    checkPolicy(dataName + " branchless", search::branchless, keys, queries);
+
+    printRow(n, dataName + " classic", nanosPerLookup(queries, [&](const T& q) {
+        return search::lowerBound(search::classic, keys, q);
+    }));
+    printRow(n, dataName + " branchless", nanosPerLookup(queries, [&](const T& q) {
+        return search::lowerBound(search::branchless, keys, q);
+    }));
+    for (std::size_t epsilon : {16, 64, 256}) {
+        search::LearnedIndex<T> learned;
+        double build = secondsFor([&] { learned = search::LearnedIndex<T>(keys, epsilon); });
+        checkIndex(dataName + " learned e=" + std::to_string(epsilon), learned, keys, queries);
+        printRow(n, dataName + " learned e=" + std::to_string(epsilon), nanosPerLookup(queries, [&](const T& q) {
+            return learned.lowerBound(q);
+        }));
+        std::cout << "            (" << learned.segmentCount() << " segments, " << learned.height() << " levels, "
+                  << learned.modelBytes() / 1024.0 << " KB model, build " << build * 1000 << " ms)" << std::endl;
+    }
+}
+
+void benchLearned(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    printHeader("learned index, int64, random queries");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        benchLearnedOn("linear", makeSortedKeys<T>(n), rng);
+        benchLearnedOn("timestamps", makeTimestampKeys<T>(n, rng), rng);
+    }
+}
+
+// Interpolation against binary search on uniform and skewed keys
+void benchInterpolation(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    printHeader("interpolation, int64, half hits");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        for (const std::string distribution : {"uniform", "zipfian", "clustered"}) {
+            std::vector<T> keys = makeDistributedKeys(distribution, n, rng);
+            std::vector<T> queries(kQueryCount);
+            for (std::size_t i = 0; i < queries.size(); ++i) {
+                queries[i] = keys[rng() % n] + static_cast<T>(i % 2);
+            }
+            checkPolicy(distribution + " classic", search::classic, keys, queries);
+            checkPolicy(distribution + " branchless", search::branchless, keys, queries);
+            checkPolicy(distribution + " interpolation", search::interpolation, keys, queries);
+            printRow(n, distribution + " classic", nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::classic, keys, q);
+            }));
+            printRow(n, distribution + " branchless", nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::branchless, keys, q);
+            }));
+            printRow(n, distribution + " interpolation", nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::interpolation, keys, q);
+            }));
+        }
+    }
+}
+
+// SearchIndex's own choice, heuristic and calibrated, against plain branchless
+template <typename T>
+void benchAdaptiveOn(const std::string& dataName, const std::vector<T>& keys, const std::vector<T>& queries) {
+    std::size_t n = keys.size();
+    checkPolicy(dataName + " branchless", search::branchless, keys, queries);
+    printRow(n, dataName + " branchless", nanosPerLookup(queries, [&](const T& q) {
+        return search::lowerBound(search::branchless, keys, q);
+    }));
+
+    search::SearchIndex<T> chosen(keys);
+    checkIndex(dataName + " auto", chosen, keys, queries);
+    printRow(n, dataName + " auto: " + search::kernelName(chosen.kernel()),
+             nanosPerLookup(queries, [&](const T& q) { return chosen.lowerBound(q); }));
+
+    search::SearchOptions options;
+    options.calibrate = true;
+    search::SearchIndex<T> calibrated;
+    double build = secondsFor([&] { calibrated = search::SearchIndex<T>(keys, options); });
+    checkIndex(dataName + " tuned", calibrated, keys, queries);
+    printRow(n, dataName + " tuned: " + search::kernelName(calibrated.kernel()),
+             nanosPerLookup(queries, [&](const T& q) { return calibrated.lowerBound(q); }));
+    std::cout << "            (calibrated build " << build * 1000 << " ms)" << std::endl;
+}
+
+void benchAdaptive(std::size_t maxElements, std::mt19937_64& rng) {
+    printHeader("adaptive SearchIndex, random queries");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        benchAdaptiveOn("int32", makeSortedKeys<int>(n), makeQueries<int>(n, kQueryCount, rng));
+
+        std::vector<std::uint64_t> stamps = makeTimestampKeys<std::uint64_t>(n, rng);
+        std::vector<std::uint64_t> stampQueries(kQueryCount);
+        for (auto& query : stampQueries) {
+            query = stamps[rng() % n] + rng() % 2;
+        }
+        benchAdaptiveOn("u64 stamps", stamps, stampQueries);
+
+        benchAdaptiveOn("double", makeSortedKeys<double>(n), makeQueries<double>(n, kQueryCount, rng));
+    }
+}
+
+#if SEARCH_HAS_MMAP
+// Major page faults taken by this process so far
+long majorFaults() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_majflt;
+}
+
+// Drops the file's pages from this process and, where the OS allows, from
+// the page cache, so the next reads go to disk
+void dropFileCache(const search::MappedKeyFile<std::int64_t>& file, const std::string& path) {
+    file.evict();
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd); // Dirty pages can't be dropped
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Searches of an mmap'd key file: sparse page index against a binary search
+// over the whole mapping, each run cold (page cache dropped) and warm
+void benchMapped(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    std::size_t n = sizesUpTo(maxElements).back();
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + "/search_bench.keys";
+    std::vector<T> keys = makeSortedKeys<T>(n);
+    search::MappedKeyFile<T>::write(path, keys);
+    search::MappedKeyFile<T> file(path);
+
+    std::vector<T> coldQueries = makeQueries<T>(n, 1 << 14, rng);
+    std::vector<T> warmQueries = makeQueries<T>(n, kQueryCount, rng);
+    printHeader("mmap'd key file, int64, " + std::to_string(n * sizeof(T) >> 20) + " MB, index " +
+                std::to_string(file.indexBytes() >> 10) + " KB");
+
+    auto run = [&](const std::string& kernel, const std::vector<T>& queries, auto lookupAll) {
+        long faults = majorFaults();
+        double seconds = secondsFor([&] { benchmarkSink = benchmarkSink + lookupAll(queries); });
+        printRow(n, kernel, seconds * 1e9 / queries.size());
+        std::cout << "            (" << static_cast<double>(majorFaults() - faults) / queries.size()
+                  << " major faults/lookup)" << std::endl;
+    };
+    auto binarySearchAll = [&](const std::vector<T>& queries) {
+        std::size_t checksum = 0;
+        for (const T& q : queries) {
+            checksum += static_cast<std::size_t>(search::binarySearch(file.begin(), file.end(), q) - file.begin());
+        }
+        return checksum;
+    };
+    auto pagedAll = [&](const std::vector<T>& queries) {
+        std::size_t checksum = 0;
+        for (const T& q : queries) {
+            checksum += file.lowerBound(q);
+        }
+        return checksum;
+    };
+    auto pagedBatch = [&](const std::vector<T>& queries) {
+        std::vector<std::size_t> results = file.lowerBoundBatch(queries);
+        std::size_t checksum = 0;
+        for (std::size_t r : results) {
+            checksum += r;
+        }
+        return checksum;
+    };
+
+    // Checked first: every cold run drops the pages these lookups touch
+    checkLookups("binarySearch mmap", warmQueries, [&](const T& q) {
+        auto found = search::binarySearch(file.begin(), file.end(), q);
+        return found == file.end() ? search::npos : firstEqual(keys, static_cast<std::size_t>(found - file.begin()));
+    }, [&](const T& q) { return stdFind(keys, q); });
+    checkLookups("page index lowerBound", warmQueries, [&](const T& q) { return file.lowerBound(q); },
+                 [&](const T& q) { return stdLowerBound(keys, q); });
+    checkLookups("page index find", warmQueries, [&](const T& q) { return firstEqual(keys, file.find(q)); },
+                 [&](const T& q) { return stdFind(keys, q); });
+    checkBatch("page index batch", warmQueries, [&](auto& q, auto& out) { out = file.lowerBoundBatch(q); },
+               [&](const T& q) { return stdLowerBound(keys, q); });
+    keys = std::vector<T>();
+
+    dropFileCache(file, path);
+    run("cold binarySearch mmap", coldQueries, binarySearchAll);
+    dropFileCache(file, path);
+    run("cold page index", coldQueries, pagedAll);
+    dropFileCache(file, path);
+    run("cold page index batch", coldQueries, pagedBatch);
+
+    // Fault every page in before the warm runs
+    std::size_t touched = 0;
+    for (std::size_t i = 0; i < n; i += file.blockKeys()) {
+        touched += static_cast<std::size_t>(file.data()[i]);
+    }
+    benchmarkSink = benchmarkSink + touched;
+    run("warm binarySearch mmap", warmQueries, binarySearchAll);
+    run("warm page index", warmQueries, pagedAll);
+    run("warm page index batch", warmQueries, pagedBatch);
+    file = search::MappedKeyFile<T>();
+    std::remove(path.c_str());
+}
+#endif
+
+// Compressed frame-of-reference blocks against the raw array: memory,
+// lookups and a full sequential scan
+template <typename T>
+void benchPackedFor(const std::string& typeName, std::uint64_t maxGap, std::size_t maxElements,
+                    std::mt19937_64& rng) {
+    printHeader("packed, " + typeName + " IDs with gaps 1-" + std::to_string(maxGap));
+    std::uniform_int_distribution<std::uint64_t> gap(1, maxGap);
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys(n);
+        std::uint64_t id = 0;
+        for (auto& key : keys) {
+            id += gap(rng);
+            key = static_cast<T>(id);
+        }
+        std::uniform_int_distribution<std::uint64_t> pick(0, id);
+        std::vector<T> queries(kQueryCount);
+        for (auto& query : queries) {
+            query = static_cast<T>(pick(rng));
+        }
+
+        search::PackedSortedArray<T> packed;
+        double build = secondsFor([&] { packed = search::PackedSortedArray<T>(keys); });
+        checkPolicy("raw branchless", search::branchless, keys, queries);
+        checkIndex("packed", packed, keys, queries);
+        std::size_t scanned = 0;
+        for (T key : packed) {
+            if (scanned >= n || key != keys[scanned]) {
+                failCheck("packed scan differs from the keys at element " + std::to_string(scanned));
+            }
+            ++scanned;
+        }
+        if (scanned != n) {
+            failCheck("packed scan stopped after " + std::to_string(scanned) + " of " + std::to_string(n) + " keys");
+        }
+        printRow(n, "raw branchless", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+        printRow(n, "packed", nanosPerLookup(queries, [&](const T& q) { return packed.lowerBound(q); }));
+
+        std::size_t checksum = 0;
+        double rawScan = secondsFor([&] {
+            for (T key : keys) {
+                checksum += static_cast<std::size_t>(key);
+            }
+        });
+        double packedScan = secondsFor([&] {
+            for (T key : packed) {
+                checksum += static_cast<std::size_t>(key);
+            }
+        });
+        benchmarkSink = benchmarkSink + checksum;
+        printRow(n, "raw scan (per key)", rawScan * 1e9 / n);
+        printRow(n, "packed scan (per key)", packedScan * 1e9 / n);
+        std::cout << "            (" << static_cast<double>(packed.memoryBytes()) * 8 / n << " bits/key, "
+                  << static_cast<double>(n * sizeof(T)) / packed.memoryBytes() << "x smaller, build "
+                  << build * 1000 << " ms)" << std::endl;
+    }
+}
+
+void benchPacked(std::size_t maxElements, std::mt19937_64& rng) {
+    benchPackedFor<std::uint32_t>("uint32", 8, maxElements, rng);
+    benchPackedFor<std::int64_t>("int64", 64, maxElements, rng);
+}
+
+// Elias-Fano against the raw array on sparse sets from a 2^40 universe
+void benchEliasFano(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    const std::uint64_t universe = std::uint64_t(1) << 40;
+    printHeader("elias-fano, int64 values from a 2^40 universe");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::uniform_int_distribution<std::uint64_t> pick(0, universe - 1);
+        std::vector<T> keys(n);
+        for (auto& key : keys) {
+            key = static_cast<T>(pick(rng));
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<T> queries(kQueryCount);
+        for (auto& query : queries) {
+            query = static_cast<T>(pick(rng));
+        }
+        std::vector<std::size_t> positions(kQueryCount);
+        for (auto& position : positions) {
+            position = rng() % n;
+        }
+
+        search::EliasFano<T> ef;
+        double build = secondsFor([&] { ef = search::EliasFano<T>(keys); });
+        checkPolicy("raw branchless", search::branchless, keys, queries);
+        checkIndex("elias-fano", ef, keys, queries);
+        checkLookups("elias-fano access", positions, [&](std::size_t i) { return static_cast<std::size_t>(ef.access(i)); },
+                     [&](std::size_t i) { return static_cast<std::size_t>(keys[i]); });
+        printRow(n, "raw branchless lowerBound", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+        printRow(n, "elias-fano nextGeq", nanosPerLookup(queries, [&](const T& q) { return ef.nextGeq(q); }));
+        printRow(n, "raw access", nanosPerLookup(positions, [&](std::size_t i) {
+            return static_cast<std::size_t>(keys[i]);
+        }));
+        printRow(n, "elias-fano access", nanosPerLookup(positions, [&](std::size_t i) {
+            return static_cast<std::size_t>(ef.access(i));
+        }));
+        // log2(universe choose n) / n, the least any encoding can average
+        double minimumBits = (std::lgamma(universe + 1.0) - std::lgamma(n + 1.0) - std::lgamma(universe - n + 1.0)) /
+                             std::log(2.0) / n;
+        std::cout << "            (" << static_cast<double>(ef.memoryBytes()) * 8 / n << " bits/value, minimum "
+                  << minimumBits << ", raw 64, build " << build * 1000 << " ms)" << std::endl;
+    }
+}
+
+
+// One mixed insert/lookup stream: operations come in chunks of one kind, so
+// each chunk can be timed on its own and inserts and lookups reported apart
+struct MixedWorkload {
+    static constexpr std::size_t kChunk = 64;
+    std::vector<std::int64_t> keys;
+    std::vector<bool> chunkIsInsert;
+};
+
+MixedWorkload makeMixedWorkload(std::size_t operations, int insertPercent, std::mt19937_64& rng) {
+    MixedWorkload workload;
+    std::uniform_int_distribution<std::int64_t> pick(0, std::int64_t(1) << 40);
+    workload.keys.resize(operations);
+    for (auto& key : workload.keys) {
+        key = pick(rng);
+    }
+    for (std::size_t chunk = 0; chunk < operations / MixedWorkload::kChunk; ++chunk) {
+        workload.chunkIsInsert.push_back(static_cast<int>(rng() % 100) < insertPercent);
+    }
+    return workload;
+}
+
+// Runs the workload and prints nanoseconds per insert and per lookup
+template <typename Insert, typename Lookup>
+void runMixed(std::size_t elements, const std::string& name, const MixedWorkload& workload, Insert insert,
+              Lookup lookup) {
+    double insertNanos = 0;
+    double lookupNanos = 0;
+    std::size_t inserts = 0;
+    std::size_t checksum = 0;
+    for (std::size_t chunk = 0; chunk < workload.chunkIsInsert.size(); ++chunk) {
+        const std::int64_t* keys = workload.keys.data() + chunk * MixedWorkload::kChunk;
+        auto start = std::chrono::steady_clock::now();
+        if (workload.chunkIsInsert[chunk]) {
+            for (std::size_t i = 0; i < MixedWorkload::kChunk; ++i) {
+                insert(keys[i]);
+            }
+        } else {
+            for (std::size_t i = 0; i < MixedWorkload::kChunk; ++i) {
+                checksum += lookup(keys[i]);
+            }
+        }
+        double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (workload.chunkIsInsert[chunk]) {
+            insertNanos += nanos;
+            ++inserts;
+        } else {
+            lookupNanos += nanos;
+        }
+    }
+    benchmarkSink = benchmarkSink + checksum;
+    std::size_t lookups = workload.chunkIsInsert.size() - inserts;
+    if (inserts > 0) {
+        printRow(elements, name + " insert", insertNanos / (inserts * MixedWorkload::kChunk));
+    }
+    if (lookups > 0) {
+        printRow(elements, name + " lookup", lookupNanos / (lookups * MixedWorkload::kChunk));
+    }
+}
+
+// Rows are labeled with the prefilled size; the workload's inserts grow the
+// set by up to 2^18 more keys while it runs
+void benchDynamic(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    constexpr std::size_t kMixedOperations = 1 << 18;
+    constexpr std::size_t kMaxVectorElements = 1 << 16; // Beyond this vector inserts take minutes
+    for (int insertPercent : {90, 50, 10}) {
+        printHeader("dynamic set, int64, " + std::to_string(insertPercent) + "% inserts / " +
+                    std::to_string(100 - insertPercent) + "% lookups");
+        for (std::size_t n : sizesUpTo(maxElements)) {
+            MixedWorkload prefill = makeMixedWorkload(n, 100, rng);
+            MixedWorkload workload = makeMixedWorkload(kMixedOperations, insertPercent, rng);
+            std::vector<T> sortedPrefill(prefill.keys);
+            std::sort(sortedPrefill.begin(), sortedPrefill.end());
+            std::vector<T> checkQueries; // Half prefilled keys, half (mostly absent) fresh ones
+            for (std::size_t i = 0; i < kCheckedQueries; ++i) {
+                checkQueries.push_back(prefill.keys[rng() % n]);
+                checkQueries.push_back(workload.keys[i % workload.keys.size()]);
+            }
+
+            for (bool cascading : {false, true}) {
+                search::DynamicSortedSet<T> set(cascading);
+                for (T key : prefill.keys) {
+                    set.insert(key);
+                }
+                std::string name = cascading ? "dynamic+cascading" : "dynamic";
+                checkLookups(name + " contains", checkQueries, [&](T q) { return static_cast<std::size_t>(set.contains(q)); },
+                             [&](T q) { return static_cast<std::size_t>(stdFind(sortedPrefill, q) != search::npos); });
+                checkLookups(name + " lowerBound", checkQueries, [&](T q) {
+                    const T* found = set.lowerBound(q);
+                    return found ? stdLowerBound(sortedPrefill, *found) : sortedPrefill.size();
+                }, [&](T q) { return stdLowerBound(sortedPrefill, q); });
+                runMixed(n, name, workload,
+                         [&](T key) { set.insert(key); },
+                         [&](T key) { return static_cast<std::size_t>(set.contains(key)); });
+                if (cascading) {
+                    std::cout << "            (" << set.runCount() << " runs, "
+                              << static_cast<double>(set.memoryBytes()) / set.size() << " bytes/key)" << std::endl;
+                }
+            }
+
+            std::multiset<T> tree(prefill.keys.begin(), prefill.keys.end());
+            runMixed(n, "std::multiset", workload, [&](T key) { tree.insert(key); },
+                     [&](T key) { return static_cast<std::size_t>(tree.find(key) != tree.end()); });
+
+            if (n <= kMaxVectorElements) {
+                std::vector<T> sorted(sortedPrefill);
+                runMixed(n, "sorted vector", workload,
+                         [&](T key) { sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), key), key); },
+                         [&](T key) {
+                             return static_cast<std::size_t>(search::binarySearch(search::branchless, sorted, key) !=
+                                                             search::npos);
+                         });
+            }
+        }
+    }
+}
+
+
+// The cache geometry the results were taken on, so runs on different
+// machines can be told apart
+void printCacheGeometry() {
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+    std::cout << "            (cache line " << sysconf(_SC_LEVEL1_DCACHE_LINESIZE) << " B, L1d "
+              << sysconf(_SC_LEVEL1_DCACHE_SIZE) / 1024 << " KiB, L2 " << sysconf(_SC_LEVEL2_CACHE_SIZE) / 1024
+              << " KiB, L3 " << sysconf(_SC_LEVEL3_CACHE_SIZE) / 1024 << " KiB)" << std::endl;
+#endif
+}
+
+// Wider keys mean fewer keys per cache line and page, the block size B the
+// van Emde Boas layout adapts to without tuning. Sizes are capped to the
+// bytes of maxElements int32 keys.
+template <typename T>
+void benchVebFor(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng) {
+    std::size_t keysPerLine = 64 / sizeof(T);
+    printHeader("van Emde Boas layout, " + typeName + ", " + std::to_string(keysPerLine) +
+                (keysPerLine == 1 ? " key per line" : " keys per line"));
+    printCacheGeometry();
+    for (std::size_t n : sizesUpTo(maxElements * 4 / sizeof(T))) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+        checkPolicy("branchless", search::branchless, keys, queries);
+
+        printRow(n, "branchless", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+        search::EytzingerIndex<T> eytzinger(keys);
+        checkIndex("eytzinger", eytzinger, keys, queries);
+        printRow(n, "eytzinger", nanosPerLookup(queries, [&](const T& q) { return eytzinger.lowerBound(q); }));
+        if constexpr (std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>) {
+            search::STree<T> stree(keys);
+            checkIndex("s-tree", stree, keys, queries);
+            printRow(n, "s-tree", nanosPerLookup(queries, [&](const T& q) { return stree.lowerBound(q); }));
+        }
+        search::VebTree<T> veb;
+        double build = secondsFor([&] { veb = search::VebTree<T>(keys); });
+        checkIndex("veb", veb, keys, queries);
+        printRow(n, "veb (build " + std::to_string(static_cast<long>(build * 1000)) + " ms)",
+                 nanosPerLookup(queries, [&](const T& q) { return veb.lowerBound(q); }));
+    }
+}
+
+void benchVeb(std::size_t maxElements, std::mt19937_64& rng) {
+    benchVebFor<std::int32_t>("int32", maxElements, rng);
+    benchVebFor<std::int64_t>("int64", maxElements, rng);
+    benchVebFor<FixedKey<16>>("16-byte keys", maxElements, rng);
+    benchVebFor<FixedKey<64>>("64-byte keys", maxElements, rng);
+}
+
+
+// Runs readers threads of lookup(thread, query) for a second while another
+// thread calls writer() until it returns false, and prints the readers'
+// combined throughput. The deadline holds even if the writer is starved.
+template <typename Query, typename Lookup, typename Writer>
+void runReadersDuring(std::size_t elements, const std::string& name, std::size_t readers,
+                      const std::vector<Query>& queries, Lookup lookup, Writer writer) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> lookups{0};
+    std::atomic<std::size_t> checksums{0}; // benchmarkSink is only written on this thread
+    std::size_t rebuilds = 0;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::size_t done = 0;
+            std::size_t checksum = 0;
+            std::size_t i = t * queries.size() / readers;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (std::size_t k = 0; k < 256; ++k, ++done) {
+                    checksum += lookup(t, queries[i]);
+                    i = i + 1 == queries.size() ? 0 : i + 1;
+                }
+            }
+            lookups += done;
+            checksums += checksum;
+        });
+    }
+    std::thread writerThread([&] {
+        while (!stop.load(std::memory_order_relaxed) && writer()) {
+            ++rebuilds;
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    benchmarkSink = benchmarkSink + checksums.load();
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    writerThread.join();
+    printRow(elements, name + " r=" + std::to_string(readers), nanos / lookups.load());
+    if (rebuilds > 0) {
+        std::cout << "            (" << rebuilds << " rebuilds)" << std::endl;
+    }
+}
+
+// Readers of a snapshot-swapped index against readers behind a
+// shared_mutex, with the writer idle and rebuilding back to back
+void benchSnapshot(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    using Index = search::SearchIndex<T>;
+    std::size_t n = std::min<std::size_t>(sizesUpTo(maxElements).back(), 1 << 21);
+    std::vector<T> keys = makeSortedKeys<T>(n);
+    std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+    auto idle = [] { return false; };
+
+    printHeader("snapshot index, int64, readers during rebuilds (hardware threads: " +
+                std::to_string(std::thread::hardware_concurrency()) + ")");
+    for (std::size_t readers = 1; readers <= 8; readers *= 2) {
+        search::SnapshotIndex<Index> snapshot(std::make_unique<const Index>(keys));
+        std::vector<search::SnapshotIndex<Index>::Reader> handles;
+        for (std::size_t t = 0; t < readers; ++t) {
+            handles.push_back(snapshot.reader());
+        }
+        auto readSnapshot = [&](std::size_t t, T q) { return handles[t].lowerBound(q); };
+        checkLookups("snapshot lowerBound", queries, [&](T q) { return readSnapshot(0, q); },
+                     [&](T q) { return stdLowerBound(keys, q); });
+        checkLookups("snapshot find", queries, [&](T q) { return firstEqual(keys, handles[0].find(q)); },
+                     [&](T q) { return stdFind(keys, q); });
+        runReadersDuring(n, "snapshot idle", readers, queries, readSnapshot, idle);
+        runReadersDuring(n, "snapshot rebuilding", readers, queries, readSnapshot, [&] {
+            snapshot.rebuild(keys);
+            return true;
+        });
+
+        std::shared_mutex mutex;
+        auto locked = std::make_unique<const Index>(keys);
+        checkIndex("shared_mutex index", *locked, keys, queries);
+        auto readLocked = [&](std::size_t, T q) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return locked->lowerBound(q);
+        };
+        runReadersDuring(n, "shared_mutex idle", readers, queries, readLocked, idle);
+        runReadersDuring(n, "shared_mutex rebuilding", readers, queries, readLocked, [&] {
+            auto next = std::make_unique<const Index>(keys);
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            locked.swap(next);
+            return true;
+        });
+    }
+}
+
+
+// Nanoseconds per element for sorting a fresh copy of data with sortFn.
+// Exits unless the result equals expected, data sorted by a stable sort
+// (or is merely ordered by less, for sorts that need not be stable).
+template <typename T, typename SortFn, typename Less>
+double nanosPerSorted(const std::string& what, const std::vector<T>& data, const std::vector<T>& expected,
+                      bool stable, Less less, SortFn sortFn) {
+    std::vector<T> copy(data);
+    double seconds = secondsFor([&] { sortFn(copy); });
+    if (stable) {
+        auto wrong = std::mismatch(copy.begin(), copy.end(), expected.begin());
+        if (wrong.first != copy.end()) {
+            failCheck(what + " differs from std::stable_sort at element " +
+                      std::to_string(wrong.first - copy.begin()));
+        }
+    } else {
+        auto wrong = std::is_sorted_until(copy.begin(), copy.end(), less);
+        if (wrong != copy.end()) {
+            failCheck(what + " is out of order at element " + std::to_string(wrong - copy.begin()));
+        }
+    }
+    benchmarkSink = benchmarkSink + static_cast<std::size_t>(copy[copy.size() / 2] < copy[0]);
+    return seconds * 1e9 / data.size();
+}
+
+template <typename T, typename KeyOf>
+void benchSortFor(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng,
+                  std::vector<T> (*make)(std::size_t, std::mt19937_64&), KeyOf keyOf) {
+    printHeader("sort " + typeName + ", random (ns and M per element; hardware threads: " +
+                std::to_string(std::thread::hardware_concurrency()) + ")");
+    auto less = [&](const T& a, const T& b) { return keyOf(a) < keyOf(b); };
+    std::vector<std::size_t> threadCounts{1};
+    if (std::thread::hardware_concurrency() > 1) {
+        threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> data = make(n, rng);
+        std::vector<T> expected(data);
+        std::stable_sort(expected.begin(), expected.end(), less);
+        printRow(n, "std::sort", nanosPerSorted("std::sort", data, expected, false, less, [&](std::vector<T>& v) {
+            std::sort(v.begin(), v.end(), less);
+        }));
+#if defined(SEARCH_BENCH_PSTL)
+        printRow(n, "std::sort par", nanosPerSorted("std::sort par", data, expected, false, less, [&](std::vector<T>& v) {
+            std::sort(std::execution::par, v.begin(), v.end(), less);
+        }));
+#endif
+        for (std::size_t threads : threadCounts) {
+            search::ThreadPool pool(threads);
+            std::string label = "radix t=" + std::to_string(threads);
+            printRow(n, label, nanosPerSorted(label, data, expected, true, less, [&](std::vector<T>& v) {
+                search::radixSort(pool, v.begin(), v.end(), keyOf);
+            }));
+        }
+    }
+}
+
+template <typename T>
+std::vector<T> makeRandomValues(std::size_t count, std::mt19937_64& rng) {
+    std::vector<T> values(count);
+    for (auto& value : values) {
+        if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(std::uniform_real_distribution<double>(-1e9, 1e9)(rng));
+        } else {
+            value = static_cast<T>(rng());
+        }
+    }
+    return values;
+}
+
+// Key-value pairs: int64 keys below 2^32 (four radix passes) with payloads
+std::vector<std::pair<std::int64_t, std::int64_t>> makeKeyValues(std::size_t count, std::mt19937_64& rng) {
+    std::vector<std::pair<std::int64_t, std::int64_t>> pairs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pairs[i] = {static_cast<std::int64_t>(rng() >> 32), static_cast<std::int64_t>(i)};
+    }
+    return pairs;
+}
+
+void benchSort(std::size_t maxElements, std::mt19937_64& rng) {
+    auto key = search::detail::RadixIdentity{};
+    benchSortFor<std::int32_t>("int32", maxElements, rng, makeRandomValues<std::int32_t>, key);
+    benchSortFor<std::int64_t>("int64", maxElements, rng, makeRandomValues<std::int64_t>, key);
+    benchSortFor<float>("float", maxElements, rng, makeRandomValues<float>, key);
+    benchSortFor<std::pair<std::int64_t, std::int64_t>>("int64 key-value", maxElements, rng, makeKeyValues,
+                                                        [](const auto& pair) { return pair.first; });
+}
+
+
+// Exact-match lookups with and without a Bloom filter in front, for
+// streams where a given share of the queries are absent keys
+void benchFilter(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n); // Odd values; even ones are misses
+        search::SearchIndex<T> plain(keys);
+        search::FilteredIndex<search::SearchIndex<T>> filtered(keys);
+        search::FilteredIndex<search::SearchIndex<T>> large(keys, 16);
+
+        std::size_t falsePositives = 0;
+        for (std::size_t i = 0; i < kQueryCount; ++i) {
+            falsePositives += filtered.filter().mayContain(static_cast<T>(2 * (rng() % n))) ? 1 : 0;
+        }
+        printHeader("bloom filter front-end, int64, " + std::to_string(n) + " keys (" +
+                    search::kernelName(plain.kernel()) + ")");
+        std::cout << "            (12 bits/key: " << std::fixed << std::setprecision(3)
+                  << 100.0 * falsePositives / kQueryCount << "% false positives, "
+                  << filtered.filter().memoryBytes() / 1024 << " KiB filter vs "
+                  << n * sizeof(T) / 1024 << " KiB keys)" << std::endl;
+
+        for (int missPercent : {0, 50, 90, 99}) {
+            std::vector<T> queries(kQueryCount);
+            for (auto& query : queries) {
+                bool miss = static_cast<int>(rng() % 100) < missPercent;
+                query = static_cast<T>(2 * (rng() % n) + (miss ? 0 : 1));
+            }
+            std::string suffix = " miss=" + std::to_string(missPercent) + "%";
+            checkIndex("no filter" + suffix, plain, keys, queries);
+            checkIndex("bloom 12b" + suffix, filtered, keys, queries);
+            checkIndex("bloom 16b" + suffix, large, keys, queries);
+            double base = nanosPerLookup(queries, [&](T q) { return plain.find(q); });
+            printRow(n, "no filter" + suffix, base);
+            printRow(n, "bloom 12b" + suffix, nanosPerLookup(queries, [&](T q) { return filtered.find(q); }));
+            printRow(n, "bloom 16b" + suffix, nanosPerLookup(queries, [&](T q) { return large.find(q); }));
+        }
+    }
+}
+
+
+// Exact-match find() through the default kernel and through the hash
+// kernel, half hits and half misses, with build cost and table size
+void benchHash(std::size_t maxElements, std::mt19937_64& rng) {
+    using T = std::int64_t;
+    printHeader("hash kernel vs search, int64 find, 50% misses");
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n); // Odd values; even ones are misses
+        std::vector<T> queries(kQueryCount);
+        for (auto& query : queries) {
+            query = static_cast<T>(2 * (rng() % n) + (rng() & 1));
+        }
+
+        search::SearchIndex<T> searched;
+        double build = secondsFor([&] { searched = search::SearchIndex<T>(keys); });
+        checkIndex(search::kernelName(searched.kernel()), searched, keys, queries);
+        printRow(n, std::string(search::kernelName(searched.kernel())) + " (build " +
+                        std::to_string(static_cast<long>(build * 1000)) + " ms)",
+                 nanosPerLookup(queries, [&](T q) { return searched.find(q); }));
+
+        search::SearchOptions options;
+        options.kernel = search::SearchKernel::Hash;
+        search::SearchIndex<T> hashed;
+        build = secondsFor([&] { hashed = search::SearchIndex<T>(keys, options); });
+        checkIndex("hash", hashed, keys, queries);
+        printRow(n, "hash (build " + std::to_string(static_cast<long>(build * 1000)) + " ms)",
+                 nanosPerLookup(queries, [&](T q) { return hashed.find(q); }));
+
+        search::HashIndex<T> table(keys);
+        std::cout << "            (hash table " << table.memoryBytes() / 1024 << " KiB vs "
+                  << n * sizeof(T) / 1024 << " KiB keys)" << std::endl;
+    }
+}
+
+
+// Branchless halving against the vectorized scan, at each instruction set
+// the CPU has: whole small arrays, then as the last phase of large searches
+template <typename T>
+void benchSimdFor(const std::string& typeName, std::size_t maxElements, std::mt19937_64& rng) {
+    std::vector<search::SimdLevel> levels;
+    for (auto level : {search::SimdLevel::Scalar, search::SimdLevel::Sse, search::SimdLevel::Avx2,
+                       search::SimdLevel::Avx512}) {
+        if (level <= search::simdLevel()) {
+            levels.push_back(level);
+        }
+    }
+    printHeader("simd scan, " + typeName + ", small arrays");
+    std::vector<std::size_t> sizes = {8, 16, 32, 64, 128, 256, 512};
+    for (std::size_t n : sizes) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+        checkPolicy("branchless", search::branchless, keys, queries);
+        for (auto level : levels) {
+            checkPolicy(std::string("simd ") + search::simdLevelName(level), search::Simd{level}, keys, queries);
+        }
+        printRow(n, "branchless", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+        for (auto level : levels) {
+            printRow(n, std::string("simd ") + search::simdLevelName(level), nanosPerLookup(queries, [&](const T& q) {
+                return search::lowerBound(search::Simd{level}, keys, q);
+            }));
+        }
+    }
+
+    printHeader("simd scan, " + typeName + ", as the last phase");
+    search::ThreadPool pool(2);
+    for (std::size_t n : sizesUpTo(maxElements)) {
+        std::vector<T> keys = makeSortedKeys<T>(n);
+        std::vector<T> queries = makeQueries<T>(n, kQueryCount, rng);
+        checkPolicy("branchless", search::branchless, keys, queries);
+        for (auto level : levels) {
+            checkPolicy(std::string("simd ") + search::simdLevelName(level), search::Simd{level}, keys, queries);
+        }
+        auto want = [&](const T& q) { return stdLowerBound(keys, q); };
+        checkBatch("simd batch", queries, [&](auto& q, auto& out) { out = search::lowerBoundBatch(search::simd, keys, q); },
+                   want);
+        checkBatch("simd parallel batch", queries, [&](auto& q, auto& out) {
+            search::parallelLowerBoundBatch(pool, search::simd, keys.begin(), keys.end(), q.data(), q.size(), out.data());
+        }, want);
+        printRow(n, "branchless", nanosPerLookup(queries, [&](const T& q) {
+            return search::lowerBound(search::branchless, keys, q);
+        }));
+        printRow(n, std::string("simd ") + search::simdLevelName(search::simdLevel()),
+                 nanosPerLookup(queries, [&](const T& q) { return search::lowerBound(search::simd, keys, q); }));
+    }
+}
+
+void benchSimd(std::size_t maxElements, std::mt19937_64& rng) {
+    benchSimdFor<std::int32_t>("int32", maxElements, rng);
+    benchSimdFor<std::int64_t>("int64", maxElements, rng);
+    benchSimdFor<double>("double", maxElements, rng);
+}
+
+
+//-----------------------------------------------------------------------------
+// Main Function - Entry Point
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    std::string suite = argc > 1 ? argv[1] : "all";
+    std::size_t maxElements = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : (1u << 24);
+    std::mt19937_64 rng(42);
+
+    bool all = (suite == "all");
+    bool ran = false;
+    if (all || suite == "types") {
+        benchTypes(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "branchless") {
+        benchBranchless(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "layouts") {
+        benchLayouts(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "batch") {
+        benchBatch(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "strategy") {
+        benchStrategies(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "parallel") {
+        benchParallel(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "learned") {
+        benchLearned(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "interpolation") {
+        benchInterpolation(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "adaptive") {
+        benchAdaptive(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "packed") {
+        benchPacked(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "elias-fano") {
+        benchEliasFano(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "dynamic") {
+        benchDynamic(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "veb") {
+        benchVeb(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "snapshot") {
+        benchSnapshot(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "sort") {
+        benchSort(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "filter") {
+        benchFilter(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "hash") {
+        benchHash(maxElements, rng);
+        ran = true;
+    }
+    if (all || suite == "simd") {
+        benchSimd(maxElements, rng);
+        ran = true;
+    }
+#if SEARCH_HAS_MMAP
+    if (all || suite == "mapped") {
+        benchMapped(maxElements, rng);
+        ran = true;
+    }
+#endif
+
+    if (!ran) {
+        std::cerr << "Unknown suite '" << suite << "'. Available: all, types, branchless, layouts, batch, strategy, parallel, learned, interpolation, adaptive, mapped, packed, elias-fano, dynamic, veb, snapshot, sort, filter, hash, simd" << std::endl;
+        return 1;
+    }
+    return 0;
+}
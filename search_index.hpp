@@ -0,0 +1,430 @@
+#ifndef SEARCH_INDEX_HPP
+#define SEARCH_INDEX_HPP
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include "search.hpp"
+#include "batch_search.hpp"
+#include "eytzinger.hpp"
+#include "stree.hpp"
+#include "learned_index.hpp"
+#include "radix_sort.hpp"
+#include "hash_index.hpp"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace search {
+
+/// The kernels a SearchIndex can run on.
+enum class SearchKernel { Auto, Branchless, Interpolation, Eytzinger, STree, Learned, Hash };
+
+inline const char* kernelName(SearchKernel kernel) {
+    switch (kernel) {
+        case SearchKernel::Auto: return "auto";
+        case SearchKernel::Branchless: return "branchless";
+        case SearchKernel::Interpolation: return "interpolation";
+        case SearchKernel::Eytzinger: return "eytzinger";
+        case SearchKernel::STree: return "s-tree";
+        case SearchKernel::Learned: return "learned";
+        case SearchKernel::Hash: return "hash";
+    }
+    return "unknown";
+}
+
+/// How a SearchIndex is built.
+struct SearchOptions {
+    /// Kernel to use; Auto picks one from the data and the machine.
+    SearchKernel kernel = SearchKernel::Auto;
+    /// With Auto, time every applicable kernel on sample lookups and keep the fastest.
+    bool calibrate = false;
+    /// Lookups timed per kernel when calibrating.
+    std::size_t calibrationLookups = 1 << 14;
+};
+
+namespace detail {
+
+// L1 data cache size in bytes, read once from sysconf where available
+inline std::size_t l1CacheBytes() {
+    static const std::size_t bytes = [] {
+        std::size_t detected = 32 << 10; // Common x86 size
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+        long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        if (l1 > 0) {
+            detected = static_cast<std::size_t>(l1);
+        }
+#endif
+        return detected;
+    }();
+    return bytes;
+}
+
+struct NoIndex {};
+
+// Largest distance, as a fraction of n, between where a straight line from
+// the first to the last key puts a sampled key and where it actually is.
+// Near 0 for uniform or sequential keys, large for skewed or clustered ones.
+template <typename T>
+double linearityError(const std::vector<T>& keys) {
+    const std::size_t n = keys.size();
+    double low = static_cast<double>(keys.front());
+    double high = static_cast<double>(keys.back());
+    if (n < 2 || !(high > low)) {
+        return 1;
+    }
+    constexpr std::size_t kSamples = 64;
+    double worst = 0;
+    for (std::size_t s = 1; s < kSamples; ++s) {
+        std::size_t position = s * (n - 1) / kSamples;
+        double predicted = (static_cast<double>(keys[position]) - low) / (high - low);
+        worst = std::max(worst, std::abs(predicted - static_cast<double>(position) / static_cast<double>(n - 1)));
+    }
+    return worst;
+}
+
+} // namespace detail
+
+/**
+ * @brief Sorted-array index that chooses its own search kernel.
+ *
+ * Built from a sorted array, it picks a kernel from the array's size in
+ * bytes against the machine's L1 cache size, the key type and, for
+ * arithmetic keys, how close the keys are to linear:
+ *
+ *   - int32/int64 keys use the S-tree, whose nodes are single cache lines,
+ *     when it was compiled with AVX2 (STree::kVectorized); its scalar node
+ *     search loses to branchless search in L1 and to Eytzinger beyond, so
+ *     without AVX2 these keys follow the rules below;
+ *   - other arrays that fit in L1 use the branchless binary search;
+ *   - floating-point keys close to linear use interpolation search;
+ *   - everything else uses the Eytzinger layout.
+ *
+ * The rule follows the 'adaptive' suite in search_bench.cpp. The learned
+ * index never beat the Eytzinger layout there on its own, so only
+ * calibration picks it: with SearchOptions::calibrate every kernel that
+ * applies is built and timed on lookups of sampled keys, and the fastest is
+ * kept. Either way the choice can be read back with kernel().
+ *
+ * SearchKernel::Hash is never picked automatically, since it answers only
+ * exact matches: callers that need just find() and contains() ask for it.
+ * Those then take about one cache miss through a HashIndex, while
+ * lowerBound() and upperBound() still work, by branchless search of the
+ * keys the index keeps alongside.
+ *
+ * Positions refer to the sorted input, as with search::lowerBound.
+ */
+template <typename T>
+class SearchIndex {
+public:
+    SearchIndex() = default;
+
+    /**
+     * @brief Builds the index from keys sorted in ascending order.
+     *
+     * @param first, last The sorted keys; the range is copied.
+     * @param options Kernel choice; by default chosen automatically.
+     */
+    template <typename RandomIt>
+    SearchIndex(RandomIt first, RandomIt last, SearchOptions options = {})
+        : SearchIndex(std::vector<T>(first, last), options, Adopt{}) {}
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit SearchIndex(const Range& sorted, SearchOptions options = {})
+        : SearchIndex(std::begin(sorted), std::end(sorted), options) {}
+
+    /**
+     * @brief Sorts keys in place and builds the index over them.
+     *
+     * Numeric keys are sorted with the parallel radixSort across pool, and
+     * other keys with std::sort. Positions refer to the sorted order.
+     */
+    static SearchIndex fromUnsorted(ThreadPool& pool, std::vector<T> keys, SearchOptions options = {}) {
+        sortKeys(pool, keys.begin(), keys.end());
+        return SearchIndex(std::move(keys), options, Adopt{});
+    }
+
+    /// fromUnsorted on the calling thread only.
+    static SearchIndex fromUnsorted(std::vector<T> keys, SearchOptions options = {}) {
+        ThreadPool pool(1);
+        return fromUnsorted(pool, std::move(keys), options);
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// The kernel chosen at build time.
+    SearchKernel kernel() const { return kernel_; }
+
+    /// Whether kernel can be used with key type T.
+    static constexpr bool supports(SearchKernel kernel) {
+        switch (kernel) {
+            case SearchKernel::Interpolation: return std::is_arithmetic_v<T>;
+            case SearchKernel::STree: return kHasSTree;
+            case SearchKernel::Learned: return kHasLearned;
+            case SearchKernel::Hash: return kHasHash;
+            default: return true;
+        }
+    }
+
+    /// Index of the first key not less than key (size() if none).
+    std::size_t lowerBound(const T& key) const {
+        switch (kernel_) {
+            case SearchKernel::Eytzinger:
+                return eytzinger_.lowerBound(key);
+            case SearchKernel::STree:
+                if constexpr (kHasSTree) {
+                    return stree_.lowerBound(key);
+                }
+                break;
+            case SearchKernel::Learned:
+                if constexpr (kHasLearned) {
+                    return learned_.lowerBound(key);
+                }
+                break;
+            case SearchKernel::Interpolation:
+                if constexpr (std::is_arithmetic_v<T>) {
+                    return search::lowerBound(interpolation, keys_, key);
+                }
+                break;
+            default:
+                break;
+        }
+        return search::lowerBound(branchless, keys_, key);
+    }
+
+    /// Index of the first key greater than key (size() if none).
+    std::size_t upperBound(const T& key) const {
+        switch (kernel_) {
+            case SearchKernel::Eytzinger:
+                return eytzinger_.upperBound(key);
+            case SearchKernel::STree:
+                if constexpr (kHasSTree) {
+                    return stree_.upperBound(key);
+                }
+                break;
+            case SearchKernel::Learned:
+                if constexpr (kHasLearned) {
+                    return learned_.upperBound(key);
+                }
+                break;
+            case SearchKernel::Interpolation:
+                if constexpr (std::is_arithmetic_v<T>) {
+                    return search::upperBound(interpolation, keys_, key);
+                }
+                break;
+            default:
+                break;
+        }
+        return search::upperBound(branchless, keys_, key);
+    }
+
+    /// Index of a key equal to key, or search::npos.
+    std::size_t find(const T& key) const {
+        switch (kernel_) {
+            case SearchKernel::Hash:
+                if constexpr (kHasHash) {
+                    return hash_.find(key);
+                }
+                break;
+            case SearchKernel::Eytzinger:
+                return eytzinger_.find(key);
+            case SearchKernel::STree:
+                if constexpr (kHasSTree) {
+                    return stree_.find(key);
+                }
+                break;
+            case SearchKernel::Learned:
+                if constexpr (kHasLearned) {
+                    return learned_.find(key);
+                }
+                break;
+            default:
+                break;
+        }
+        std::size_t position = lowerBound(key);
+        return (position < keys_.size() && !(key < keys_[position])) ? position : npos;
+    }
+
+    bool contains(const T& key) const { return find(key) != npos; }
+
+    /**
+     * @brief Lower bound for many keys, with the chosen kernel's batch form.
+     *
+     * @param results Receives lowerBound(queries[i]) at index i.
+     */
+    void lowerBoundBatch(const T* queries, std::size_t count, std::size_t* results) const {
+        switch (kernel_) {
+            case SearchKernel::Eytzinger:
+                eytzinger_.lowerBoundBatch(queries, count, results);
+                return;
+            case SearchKernel::STree:
+                if constexpr (kHasSTree) {
+                    stree_.lowerBoundBatch(queries, count, results);
+                    return;
+                }
+                break;
+            case SearchKernel::Learned:
+                if constexpr (kHasLearned) {
+                    search::lowerBoundBatch(learned_, queries, count, results);
+                    return;
+                }
+                break;
+            case SearchKernel::Interpolation:
+                if constexpr (std::is_arithmetic_v<T>) {
+                    search::lowerBoundBatch(interpolation, keys_.begin(), keys_.end(), queries, count, results);
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        search::lowerBoundBatch(branchless, keys_.begin(), keys_.end(), queries, count, results);
+    }
+
+    std::vector<std::size_t> lowerBoundBatch(const std::vector<T>& queries) const {
+        std::vector<std::size_t> results(queries.size());
+        lowerBoundBatch(queries.data(), queries.size(), results.data());
+        return results;
+    }
+
+private:
+    struct Adopt {};
+
+    // Builds over sorted keys, taking ownership of them
+    SearchIndex(std::vector<T> sorted, SearchOptions options, Adopt) : keys_(std::move(sorted)) {
+        SearchKernel kernel = options.kernel;
+        if (kernel == SearchKernel::Auto) {
+            kernel = options.calibrate ? calibrate(options.calibrationLookups) : chooseKernel();
+        } else if (!supports(kernel)) {
+            kernel = SearchKernel::Branchless;
+        }
+        build(kernel);
+    }
+
+    static constexpr bool kHasSTree = std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>;
+    static constexpr bool kHasLearned = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+    static constexpr bool kHasHash = detail::kHashable<T>;
+    // Keys within this fraction of a straight line count as near-linear
+    static constexpr double kLinearError = 0.01;
+
+    using STreeIndex = std::conditional_t<kHasSTree, STree<T>, detail::NoIndex>;
+    using LearnedIndexType = std::conditional_t<kHasLearned, LearnedIndex<T>, detail::NoIndex>;
+    using HashIndexType = std::conditional_t<kHasHash, HashIndex<T>, detail::NoIndex>;
+
+    SearchKernel kernel_ = SearchKernel::Branchless;
+    std::size_t count_ = 0;
+    std::vector<T> keys_; // Kept only by the kernels that search the array itself
+    EytzingerIndex<T> eytzinger_;
+    STreeIndex stree_{};
+    LearnedIndexType learned_{};
+    HashIndexType hash_{};
+
+    SearchKernel chooseKernel() const {
+        if constexpr (kHasSTree) {
+            if constexpr (STreeIndex::kVectorized) {
+                return SearchKernel::STree;
+            }
+        }
+        if (keys_.size() * sizeof(T) <= detail::l1CacheBytes()) {
+            return SearchKernel::Branchless;
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            if (detail::linearityError(keys_) <= kLinearError) {
+                return SearchKernel::Interpolation;
+            }
+        }
+        return SearchKernel::Eytzinger;
+    }
+
+    // Builds every applicable kernel in turn and times it on the same sample
+    // of lookups (half present keys, half their successors for arithmetic
+    // keys). Only the winner's structure is kept.
+    SearchKernel calibrate(std::size_t lookups) {
+        if (keys_.empty()) {
+            return SearchKernel::Branchless;
+        }
+        std::mt19937_64 rng(keys_.size());
+        std::vector<T> queries(lookups);
+        for (std::size_t i = 0; i < lookups; ++i) {
+            queries[i] = keys_[rng() % keys_.size()];
+            if constexpr (std::is_arithmetic_v<T>) {
+                if (i % 2 == 1 && queries[i] != std::numeric_limits<T>::max()) {
+                    queries[i] = static_cast<T>(queries[i] + 1);
+                }
+            }
+        }
+
+        SearchKernel best = SearchKernel::Branchless;
+        double bestSeconds = 0;
+        for (SearchKernel candidate : {SearchKernel::Branchless, SearchKernel::Interpolation, SearchKernel::Eytzinger,
+                                       SearchKernel::STree, SearchKernel::Learned}) {
+            if (!supports(candidate)) {
+                continue;
+            }
+            build(candidate, true);
+            std::size_t checksum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (const T& query : queries) {
+                checksum += lowerBound(query);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            volatile std::size_t sink = checksum; // Keeps the lookups from being optimized out
+            (void)sink;
+            if (candidate == SearchKernel::Branchless || seconds < bestSeconds) {
+                best = candidate;
+                bestSeconds = seconds;
+            }
+            release();
+        }
+        return best;
+    }
+
+    // keys_ must hold the sorted keys; unless keepKeys, it is dropped when the
+    // kernel has its own copy.
+    void build(SearchKernel kernel, bool keepKeys = false) {
+        kernel_ = kernel;
+        count_ = keys_.size();
+        switch (kernel) {
+            case SearchKernel::Eytzinger:
+                eytzinger_ = EytzingerIndex<T>(keys_);
+                break;
+            case SearchKernel::STree:
+                if constexpr (kHasSTree) {
+                    stree_ = STree<T>(keys_);
+                }
+                break;
+            case SearchKernel::Learned:
+                if constexpr (kHasLearned) {
+                    learned_ = LearnedIndex<T>(keys_);
+                }
+                break;
+            case SearchKernel::Hash:
+                if constexpr (kHasHash) {
+                    hash_ = HashIndex<T>(keys_);
+                }
+                return; // Range queries still search keys_
+            default:
+                return;
+        }
+        if (!keepKeys) {
+            std::vector<T>().swap(keys_);
+        }
+    }
+
+    // Drops any built layout, keeping keys_ for the next candidate
+    void release() {
+        eytzinger_ = EytzingerIndex<T>();
+        stree_ = STreeIndex{};
+        learned_ = LearnedIndexType{};
+        hash_ = HashIndexType{};
+    }
+};
+
+} // namespace search
+
+#endif // SEARCH_INDEX_HPP
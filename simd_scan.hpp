@@ -0,0 +1,261 @@
+#ifndef SIMD_SCAN_HPP
+#define SIMD_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SEARCH_HAS_SIMD_DISPATCH 1
+#include <immintrin.h>
+#else
+#define SEARCH_HAS_SIMD_DISPATCH 0
+#endif
+
+namespace search {
+
+/// Instruction sets the vectorized scans can run on, weakest first.
+enum class SimdLevel { Scalar, Sse, Avx2, Avx512 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse: return "sse4.2";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+// The level the compiler may assume (-mavx2, -march=native...): kernels up
+// to it need no CPU check and can be inlined
+inline constexpr SimdLevel kSimdBaseline =
+#if SEARCH_HAS_SIMD_DISPATCH && defined(__AVX512F__)
+    SimdLevel::Avx512;
+#elif SEARCH_HAS_SIMD_DISPATCH && defined(__AVX2__)
+    SimdLevel::Avx2;
+#elif SEARCH_HAS_SIMD_DISPATCH && defined(__SSE4_2__)
+    SimdLevel::Sse;
+#else
+    SimdLevel::Scalar;
+#endif
+
+inline SimdLevel detectSimdLevel() {
+#if SEARCH_HAS_SIMD_DISPATCH
+    if (kSimdBaseline == SimdLevel::Avx512) {
+        return kSimdBaseline;
+    }
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::Sse;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+} // namespace detail
+
+/// The best level this CPU supports, detected on first use.
+inline SimdLevel simdLevel() {
+    static const SimdLevel level = detail::detectSimdLevel();
+    return level;
+}
+
+namespace detail {
+
+// Element types with vector kernels: 32- and 64-bit integers and floats
+template <typename T>
+inline constexpr bool kSimdScannable =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// The kernels below count the elements of p[0, n) that are less than key,
+// or not greater than it when OrEqual; in a sorted range that count is the
+// lower (upper) bound. They compare a whole register of keys per step and
+// never branch on the result, so the trip count depends on n alone.
+
+template <bool OrEqual, typename T>
+std::size_t countBelowScalar(const T* p, std::size_t n, T key) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        count += (OrEqual ? !(key < p[i]) : p[i] < key) ? 1 : 0;
+    }
+    return count;
+}
+
+#if SEARCH_HAS_SIMD_DISPATCH
+
+// Integer lanes compare as signed; unsigned keys get their sign bit flipped
+template <typename T>
+inline constexpr std::int64_t kSimdBias =
+    std::is_unsigned_v<T> ? std::int64_t(1) << (8 * sizeof(T) - 1) : 0;
+
+template <bool OrEqual, typename T>
+__attribute__((target("sse4.2,popcnt")))
+std::size_t countBelowSse(const T* p, std::size_t n, T key) {
+    constexpr std::size_t kLanes = 16 / sizeof(T);
+    std::size_t bytes = 0; // Mask bits set: sizeof(T) per lane that counts
+    std::size_t i = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+        for (; i + kLanes <= n; i += kLanes) {
+            int mask;
+            if constexpr (sizeof(T) == 4) {
+                __m128 target = _mm_set1_ps(key);
+                __m128 keys = _mm_loadu_ps(p + i);
+                mask = _mm_movemask_epi8(_mm_castps_si128(OrEqual ? _mm_cmple_ps(keys, target)
+                                                                  : _mm_cmplt_ps(keys, target)));
+            } else {
+                __m128d target = _mm_set1_pd(key);
+                __m128d keys = _mm_loadu_pd(p + i);
+                mask = _mm_movemask_epi8(_mm_castpd_si128(OrEqual ? _mm_cmple_pd(keys, target)
+                                                                  : _mm_cmplt_pd(keys, target)));
+            }
+            bytes += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+        }
+    } else {
+        const __m128i bias = sizeof(T) == 4 ? _mm_set1_epi32(static_cast<int>(kSimdBias<T>))
+                                            : _mm_set1_epi64x(kSimdBias<T>);
+        const __m128i target = _mm_xor_si128(sizeof(T) == 4 ? _mm_set1_epi32(static_cast<int>(key))
+                                                            : _mm_set1_epi64x(static_cast<long long>(key)),
+                                             bias);
+        for (; i + kLanes <= n; i += kLanes) {
+            __m128i keys = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias);
+            // key > element counts it as less; element > key rules it out
+            __m128i greater;
+            if constexpr (sizeof(T) == 4) {
+                greater = OrEqual ? _mm_cmpgt_epi32(keys, target) : _mm_cmpgt_epi32(target, keys);
+            } else {
+                greater = OrEqual ? _mm_cmpgt_epi64(keys, target) : _mm_cmpgt_epi64(target, keys);
+            }
+            std::size_t set = static_cast<std::size_t>(__builtin_popcount(
+                static_cast<unsigned>(_mm_movemask_epi8(greater))));
+            bytes += OrEqual ? 16 - set : set;
+        }
+    }
+    return bytes / sizeof(T) + countBelowScalar<OrEqual>(p + i, n - i, key);
+}
+
+template <bool OrEqual, typename T>
+__attribute__((target("avx2,popcnt")))
+std::size_t countBelowAvx2(const T* p, std::size_t n, T key) {
+    constexpr std::size_t kLanes = 32 / sizeof(T);
+    std::size_t bytes = 0;
+    std::size_t i = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+        for (; i + kLanes <= n; i += kLanes) {
+            int mask;
+            if constexpr (sizeof(T) == 4) {
+                __m256 compared = _mm256_cmp_ps(_mm256_loadu_ps(p + i), _mm256_set1_ps(key),
+                                                OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+                mask = _mm256_movemask_epi8(_mm256_castps_si256(compared));
+            } else {
+                __m256d compared = _mm256_cmp_pd(_mm256_loadu_pd(p + i), _mm256_set1_pd(key),
+                                                 OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+                mask = _mm256_movemask_epi8(_mm256_castpd_si256(compared));
+            }
+            bytes += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+        }
+    } else {
+        const __m256i bias = sizeof(T) == 4 ? _mm256_set1_epi32(static_cast<int>(kSimdBias<T>))
+                                            : _mm256_set1_epi64x(kSimdBias<T>);
+        const __m256i target = _mm256_xor_si256(sizeof(T) == 4 ? _mm256_set1_epi32(static_cast<int>(key))
+                                                               : _mm256_set1_epi64x(static_cast<long long>(key)),
+                                                bias);
+        for (; i + kLanes <= n; i += kLanes) {
+            __m256i keys = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias);
+            __m256i greater;
+            if constexpr (sizeof(T) == 4) {
+                greater = OrEqual ? _mm256_cmpgt_epi32(keys, target) : _mm256_cmpgt_epi32(target, keys);
+            } else {
+                greater = OrEqual ? _mm256_cmpgt_epi64(keys, target) : _mm256_cmpgt_epi64(target, keys);
+            }
+            std::size_t set = static_cast<std::size_t>(__builtin_popcount(
+                static_cast<unsigned>(_mm256_movemask_epi8(greater))));
+            bytes += OrEqual ? 32 - set : set;
+        }
+    }
+    return bytes / sizeof(T) + countBelowScalar<OrEqual>(p + i, n - i, key);
+}
+
+// AVX-512 compares yield lane masks directly, and a masked load and compare
+// handle the tail, so there is no scalar loop
+template <bool OrEqual, typename T>
+__attribute__((target("avx512f,popcnt")))
+std::size_t countBelowAvx512(const T* p, std::size_t n, T key) {
+    constexpr std::size_t kLanes = 64 / sizeof(T);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i += kLanes) {
+        std::size_t lanes = n - i < kLanes ? n - i : kLanes;
+        unsigned active = lanes == kLanes ? (1u << kLanes) - 1 : (1u << lanes) - 1;
+        unsigned mask;
+        if constexpr (std::is_same_v<T, float>) {
+            __m512 keys = _mm512_maskz_loadu_ps(static_cast<__mmask16>(active), p + i);
+            mask = _mm512_mask_cmp_ps_mask(static_cast<__mmask16>(active), keys, _mm512_set1_ps(key),
+                                           OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+        } else if constexpr (std::is_same_v<T, double>) {
+            __m512d keys = _mm512_maskz_loadu_pd(static_cast<__mmask8>(active), p + i);
+            mask = _mm512_mask_cmp_pd_mask(static_cast<__mmask8>(active), keys, _mm512_set1_pd(key),
+                                           OrEqual ? _CMP_LE_OQ : _CMP_LT_OQ);
+        } else if constexpr (sizeof(T) == 4) {
+            __mmask16 lanesMask = static_cast<__mmask16>(active);
+            __m512i keys = _mm512_maskz_loadu_epi32(lanesMask, p + i);
+            __m512i target = _mm512_set1_epi32(static_cast<int>(key));
+            if constexpr (std::is_unsigned_v<T>) {
+                mask = OrEqual ? _mm512_mask_cmple_epu32_mask(lanesMask, keys, target)
+                               : _mm512_mask_cmplt_epu32_mask(lanesMask, keys, target);
+            } else {
+                mask = OrEqual ? _mm512_mask_cmple_epi32_mask(lanesMask, keys, target)
+                               : _mm512_mask_cmplt_epi32_mask(lanesMask, keys, target);
+            }
+        } else {
+            __mmask8 lanesMask = static_cast<__mmask8>(active);
+            __m512i keys = _mm512_maskz_loadu_epi64(lanesMask, p + i);
+            __m512i target = _mm512_set1_epi64(static_cast<long long>(key));
+            if constexpr (std::is_unsigned_v<T>) {
+                mask = OrEqual ? _mm512_mask_cmple_epu64_mask(lanesMask, keys, target)
+                               : _mm512_mask_cmplt_epu64_mask(lanesMask, keys, target);
+            } else {
+                mask = OrEqual ? _mm512_mask_cmple_epi64_mask(lanesMask, keys, target)
+                               : _mm512_mask_cmplt_epi64_mask(lanesMask, keys, target);
+            }
+        }
+        count += static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    return count;
+}
+
+#endif // SEARCH_HAS_SIMD_DISPATCH
+
+// Counts with the kernel for level, or the best one below it that the CPU has
+template <bool OrEqual, typename T>
+std::size_t countBelow(SimdLevel level, const T* p, std::size_t n, T key) {
+#if SEARCH_HAS_SIMD_DISPATCH
+    if (level > kSimdBaseline) {
+        SimdLevel supported = simdLevel();
+        level = level < supported ? level : supported;
+    }
+    switch (level) {
+        case SimdLevel::Avx512: return countBelowAvx512<OrEqual>(p, n, key);
+        case SimdLevel::Avx2: return countBelowAvx2<OrEqual>(p, n, key);
+        case SimdLevel::Sse: return countBelowSse<OrEqual>(p, n, key);
+        case SimdLevel::Scalar: break;
+    }
+#else
+    (void)level;
+#endif
+    return countBelowScalar<OrEqual>(p, n, key);
+}
+
+} // namespace detail
+
+} // namespace search
+
+#endif // SIMD_SCAN_HPP
@@ -0,0 +1,204 @@
+#ifndef SNAPSHOT_INDEX_HPP
+#define SNAPSHOT_INDEX_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace search {
+
+/**
+ * @brief Index that can be replaced while other threads keep searching it.
+ *
+ * Readers search an immutable snapshot (any index type: SearchIndex,
+ * EytzingerIndex, a sorted vector...). A writer builds the next snapshot off
+ * to the side and publishes it with a single atomic pointer exchange, so a
+ * reader always sees one whole snapshot, old or new, and never waits.
+ *
+ * Old snapshots are freed by epoch-based reclamation. Each reader owns a
+ * slot in which it announces the global epoch before loading the snapshot
+ * pointer, and clears it afterwards. Publishing advances the epoch, and a
+ * retired snapshot is freed once every slot is either clear or announces a
+ * later epoch: such readers loaded the pointer after the exchange.
+ *
+ * The read path is two plain stores, one fence and two loads: no locks and
+ * no atomic read-modify-writes, so readers on different cores do not
+ * contend for a cache line. Writers take a mutex among themselves.
+ */
+template <typename Index>
+class SnapshotIndex {
+    struct ReaderSlot;
+
+public:
+    /**
+     * @brief A thread's handle for searching the current snapshot.
+     *
+     * Obtain one per reader thread with reader(). A Reader is not itself
+     * thread-safe, and it must not outlive its SnapshotIndex.
+     */
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept : owner_(other.owner_), slot_(std::exchange(other.slot_, nullptr)) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        ~Reader() {
+            if (slot_) {
+                owner_->releaseSlot(slot_);
+            }
+        }
+
+        /**
+         * @brief Calls fn(const Index&) on the current snapshot.
+         *
+         * The snapshot stays alive until fn returns; fn must not keep
+         * references into it, and must not call read() again.
+         *
+         * @return Whatever fn returns.
+         */
+        template <typename Fn>
+        decltype(auto) read(Fn&& fn) const {
+            struct Unpin {
+                ReaderSlot* slot;
+                ~Unpin() { slot->epoch.store(0, std::memory_order_release); }
+            } unpin{slot_};
+            // Announce the epoch before loading the pointer; the fence keeps
+            // the writer from missing the announcement after the exchange
+            slot_->epoch.store(owner_->epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return std::forward<Fn>(fn)(*owner_->current_.load(std::memory_order_acquire));
+        }
+
+        /// The current snapshot's lowerBound(key).
+        template <typename Key>
+        std::size_t lowerBound(const Key& key) const {
+            return read([&](const Index& index) { return index.lowerBound(key); });
+        }
+
+        /// The current snapshot's find(key).
+        template <typename Key>
+        std::size_t find(const Key& key) const {
+            return read([&](const Index& index) { return index.find(key); });
+        }
+
+    private:
+        friend class SnapshotIndex;
+
+        const SnapshotIndex* owner_;
+        ReaderSlot* slot_;
+
+        Reader(const SnapshotIndex* owner, ReaderSlot* slot) : owner_(owner), slot_(slot) {}
+    };
+
+    /// @param initial The first snapshot; must not be null.
+    explicit SnapshotIndex(std::unique_ptr<const Index> initial) : current_(initial.release()) {}
+
+    /// Every Reader must have been destroyed.
+    ~SnapshotIndex() { delete current_.load(std::memory_order_relaxed); }
+
+    SnapshotIndex(const SnapshotIndex&) = delete;
+    SnapshotIndex& operator=(const SnapshotIndex&) = delete;
+
+    /// Registers a reader; takes a lock, so do it once per thread.
+    Reader reader() const {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        for (auto& slot : slots_) {
+            if (!slot->inUse) {
+                slot->inUse = true;
+                return Reader(this, slot.get());
+            }
+        }
+        slots_.push_back(std::make_unique<ReaderSlot>());
+        slots_.back()->inUse = true;
+        return Reader(this, slots_.back().get());
+    }
+
+    /**
+     * @brief Makes next the current snapshot.
+     *
+     * Readers already inside read() finish on the old snapshot, which is
+     * freed by this or a later publish() or reclaim() once they are done.
+     */
+    void publish(std::unique_ptr<const Index> next) {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        const Index* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        // Readers that announce this epoch or later load the new pointer
+        std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired_.push_back({epoch, std::unique_ptr<const Index>(old)});
+        reclaimLocked();
+    }
+
+    /// Builds an Index from args and publishes it.
+    template <typename... Args>
+    void rebuild(Args&&... args) {
+        publish(std::make_unique<const Index>(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Frees the retired snapshots no reader can still be using.
+     *
+     * @return Retired snapshots still waiting for readers.
+     */
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return reclaimLocked();
+    }
+
+    /// Epochs advance by one per publish(), starting at 1.
+    std::uint64_t epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+private:
+    // Its own cache line, so readers never share one
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{0}; // 0 while outside read()
+        bool inUse = false;                  // Guarded by slotMutex_
+    };
+
+    struct Retired {
+        std::uint64_t epoch; // Safe once no reader announces an earlier one
+        std::unique_ptr<const Index> index;
+    };
+
+    std::atomic<const Index*> current_;
+    std::atomic<std::uint64_t> epoch_{1};
+    mutable std::mutex slotMutex_;
+    mutable std::vector<std::unique_ptr<ReaderSlot>> slots_;
+    std::mutex writerMutex_;
+    std::vector<Retired> retired_;
+
+    void releaseSlot(ReaderSlot* slot) const {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        slot->inUse = false;
+    }
+
+    std::size_t reclaimLocked() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t oldestActive = UINT64_MAX;
+        {
+            std::lock_guard<std::mutex> lock(slotMutex_);
+            for (const auto& slot : slots_) {
+                std::uint64_t announced = slot->epoch.load(std::memory_order_acquire);
+                if (announced != 0 && announced < oldestActive) {
+                    oldestActive = announced;
+                }
+            }
+        }
+        std::size_t kept = 0;
+        for (Retired& retired : retired_) {
+            if (retired.epoch > oldestActive) {
+                retired_[kept++] = std::move(retired);
+            }
+        }
+        retired_.resize(kept);
+        return kept;
+    }
+};
+
+} // namespace search
+
+#endif // SNAPSHOT_INDEX_HPP
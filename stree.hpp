@@ -0,0 +1,206 @@
+#ifndef STREE_HPP
+#define STREE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "search.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace search {
+
+namespace detail {
+
+inline int popCount(std::uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Static B+-tree ("S-tree") over sorted 32- or 64-bit signed integers.
+ *
+ * Every node is one 64-byte cache line holding B keys (16 int32 or 8 int64)
+ * and has B + 1 children, so a lookup touches one line per level and the
+ * tree is about log_17(n) levels deep for int32. The bottom layer is the
+ * sorted array itself, padded with the maximum value to a whole number of
+ * nodes; key i of an internal node is the smallest key of its child i + 1.
+ *
+ * Inside a node, the number of keys below the target picks the child. With
+ * AVX2 that count is two vector compares, a movemask and a popcount;
+ * otherwise a plain loop computes the same count.
+ */
+template <typename T>
+class STree {
+    static_assert(std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>,
+                  "STree supports int32_t and int64_t keys");
+
+public:
+    static constexpr std::size_t kNodeKeys = 64 / sizeof(T);
+    /// Whether node search was compiled with the AVX2 compares.
+#if defined(__AVX2__)
+    static constexpr bool kVectorized = true;
+#else
+    static constexpr bool kVectorized = false;
+#endif
+
+    STree() = default;
+
+    /// Builds the tree bottom-up from keys sorted in ascending order.
+    template <typename RandomIt>
+    STree(RandomIt first, RandomIt last) : count_(static_cast<std::size_t>(last - first)) {
+        // Node counts per layer, leaves first
+        std::vector<std::size_t> layerNodes{(count_ + kNodeKeys - 1) / kNodeKeys};
+        while (layerNodes.back() > 1) {
+            layerNodes.push_back((layerNodes.back() + kNodeKeys) / (kNodeKeys + 1));
+        }
+
+        // Store the root layer first so a descent moves forward through memory
+        std::size_t totalNodes = 0;
+        layerOffset_.resize(layerNodes.size());
+        for (std::size_t layer = layerNodes.size(); layer-- > 0;) {
+            layerOffset_[layer] = totalNodes;
+            totalNodes += layerNodes[layer];
+        }
+        nodes_.assign(totalNodes * kNodeKeys, std::numeric_limits<T>::max());
+
+        T* leaves = nodes_.data() + layerOffset_[0] * kNodeKeys;
+        std::copy(first, last, leaves);
+
+        // The smallest key under a child is the first key of its leftmost leaf
+        std::size_t leavesPerChild = 1;
+        for (std::size_t layer = 1; layer < layerNodes.size(); ++layer) {
+            T* node = nodes_.data() + layerOffset_[layer] * kNodeKeys;
+            for (std::size_t k = 0; k < layerNodes[layer]; ++k, node += kNodeKeys) {
+                for (std::size_t i = 0; i < kNodeKeys; ++i) {
+                    std::size_t leaf = (k * (kNodeKeys + 1) + i + 1) * leavesPerChild;
+                    if (leaf < layerNodes[0]) {
+                        node[i] = leaves[leaf * kNodeKeys];
+                    }
+                }
+            }
+            leavesPerChild *= kNodeKeys + 1;
+        }
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit STree(const Range& sorted) : STree(std::begin(sorted), std::end(sorted)) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Index of the first key >= key in the sorted input (size() if none).
+    std::size_t lowerBound(T key) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        std::size_t k = 0;
+        for (std::size_t layer = layerOffset_.size() - 1; layer > 0; --layer) {
+            k = k * (kNodeKeys + 1) + countLess(node(layer, k), key);
+        }
+        std::size_t position = k * kNodeKeys + countLess(node(0, k), key);
+        return position < count_ ? position : count_;
+    }
+
+    /// Index of the first key > key in the sorted input (size() if none).
+    std::size_t upperBound(T key) const {
+        return key == std::numeric_limits<T>::max() ? count_ : lowerBound(key + 1);
+    }
+
+    /// Index of key in the sorted input, or search::npos.
+    std::size_t find(T key) const {
+        std::size_t position = lowerBound(key);
+        return (position < count_ && nodes_[layerOffset_[0] * kNodeKeys + position] == key) ? position : npos;
+    }
+
+    /**
+     * @brief Lower bound for many keys at once.
+     *
+     * All descents have the same depth, so a group of queries walks the tree
+     * layer by layer together, prefetching each query's next node first.
+     *
+     * @param results Receives lowerBound(queries[i]) at index i.
+     */
+    void lowerBoundBatch(const T* queries, std::size_t count, std::size_t* results) const {
+        if (count_ == 0) {
+            std::fill(results, results + count, std::size_t(0));
+            return;
+        }
+        std::size_t k[kBatchGroup];
+        for (std::size_t start = 0; start < count; start += kBatchGroup) {
+            std::size_t group = std::min(kBatchGroup, count - start);
+            const T* keys = queries + start;
+            for (std::size_t i = 0; i < group; ++i) {
+                k[i] = 0;
+            }
+            for (std::size_t layer = layerOffset_.size() - 1; layer > 0; --layer) {
+                for (std::size_t i = 0; i < group; ++i) {
+                    k[i] = k[i] * (kNodeKeys + 1) + countLess(node(layer, k[i]), keys[i]);
+                    detail::prefetch(node(layer - 1, k[i]));
+                }
+            }
+            for (std::size_t i = 0; i < group; ++i) {
+                std::size_t position = k[i] * kNodeKeys + countLess(node(0, k[i]), keys[i]);
+                results[start + i] = position < count_ ? position : count_;
+            }
+        }
+    }
+
+    /// Bytes used by all layers, including padding.
+    std::size_t memoryBytes() const { return nodes_.size() * sizeof(T); }
+
+private:
+    std::size_t count_ = 0;
+    std::vector<std::size_t> layerOffset_; // First node of each layer, leaves at [0]
+    std::vector<T, detail::AlignedAllocator<T>> nodes_;
+
+    const T* node(std::size_t layer, std::size_t k) const {
+        return nodes_.data() + (layerOffset_[layer] + k) * kNodeKeys;
+    }
+
+    // Number of keys in a node that are less than key
+    static std::size_t countLess(const T* node, T key) {
+#if defined(__AVX2__)
+        if constexpr (sizeof(T) == 4) {
+            __m256i target = _mm256_set1_epi32(key);
+            __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+            __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+            std::uint32_t mask = static_cast<std::uint32_t>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, low))))
+                | (static_cast<std::uint32_t>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, high)))) << 8);
+            return static_cast<std::size_t>(detail::popCount(mask));
+        } else {
+            __m256i target = _mm256_set1_epi64x(key);
+            __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+            __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 4));
+            std::uint32_t mask = static_cast<std::uint32_t>(
+                _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, low))))
+                | (static_cast<std::uint32_t>(
+                _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, high)))) << 4);
+            return static_cast<std::size_t>(detail::popCount(mask));
+        }
+#else
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < kNodeKeys; ++i) {
+            count += node[i] < key ? 1 : 0;
+        }
+        return count;
+#endif
+    }
+};
+
+} // namespace search
+
+#endif // STREE_HPP
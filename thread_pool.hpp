@@ -0,0 +1,121 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace search {
+
+/**
+ * @brief Fixed set of worker threads for data-parallel loops.
+ *
+ * parallelFor(tasks, fn) runs fn(0) ... fn(tasks - 1) across the workers and
+ * the calling thread, which takes tasks too, and returns when all are done.
+ * Tasks are claimed dynamically from a shared counter, so uneven tasks
+ * balance out. fn must not throw.
+ */
+class ThreadPool {
+public:
+    /// @param threads Total threads including the caller (at least 1).
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (std::size_t i = 1; i < threads; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Threads that run tasks, including the caller of parallelFor.
+    std::size_t size() const { return workers_.size() + 1; }
+
+    void parallelFor(std::size_t tasks, const std::function<void(std::size_t)>& fn) {
+        if (workers_.empty() || tasks <= 1) {
+            for (std::size_t task = 0; task < tasks; ++task) {
+                fn(task);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            taskCount_ = tasks;
+            nextTask_.store(0, std::memory_order_relaxed);
+            busyWorkers_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        runTasks(fn, tasks);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busyWorkers_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t taskCount_ = 0;
+    std::atomic<std::size_t> nextTask_{0};
+    std::size_t busyWorkers_ = 0;
+    std::uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    void runTasks(const std::function<void(std::size_t)>& fn, std::size_t tasks) {
+        for (std::size_t task = nextTask_.fetch_add(1); task < tasks; task = nextTask_.fetch_add(1)) {
+            fn(task);
+        }
+    }
+
+    void workerLoop() {
+        std::uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(std::size_t)>* job;
+            std::size_t tasks;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+                tasks = taskCount_;
+            }
+            runTasks(*job, tasks);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--busyWorkers_ == 0) {
+                    done_.notify_one();
+                }
+            }
+        }
+    }
+};
+
+} // namespace search
+
+#endif // THREAD_POOL_HPP
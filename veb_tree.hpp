@@ -0,0 +1,176 @@
+#ifndef VEB_TREE_HPP
+#define VEB_TREE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <array>
+#include "search.hpp"
+
+namespace search {
+
+/**
+ * @brief Read-only search tree over a sorted array in van Emde Boas order.
+ *
+ * The keys form a perfect binary search tree of height h. It is cut at half
+ * its height into a top tree and 2^(h/2) bottom trees, which are laid out one
+ * after the other, each recursively in the same way. Whatever the size B of
+ * a cache line, page or any other block, the recursion reaches subtrees of
+ * between sqrt(B) and B keys that sit in one or two blocks, so a lookup
+ * touches O(log_B n) blocks at every level of the memory hierarchy at once,
+ * with no block size to tune. (S-tree gets log_17 n for one fixed size.)
+ *
+ * The descent computes each node's position from its BFS index with tables
+ * per depth (Brodal, Fagerberg and Jacob): a node at depth d lies in the
+ * bottom tree hanging below depth D[d], after that tree's T[d]-node top tree
+ * and (i & T[d]) sibling bottom trees of B[d] nodes each.
+ *
+ * Missing keys up to 2^h - 1 repeat the largest key, so the tree uses up to
+ * twice the memory of the array. Results are positions in the original
+ * sorted array, as returned by search::lowerBound on that array.
+ */
+template <typename T, typename Compare = std::less<>>
+class VebTree {
+public:
+    VebTree() = default;
+
+    /**
+     * @brief Builds the tree from a sorted range.
+     *
+     * @param first, last Keys sorted by comp; the range is copied.
+     * @param comp The ordering the keys are sorted by.
+     */
+    template <typename RandomIt>
+    VebTree(RandomIt first, RandomIt last, Compare comp = {})
+        : comp_(comp), count_(static_cast<std::size_t>(last - first)) {
+        if (count_ == 0) {
+            return;
+        }
+        height_ = detail::floorLog2(count_) + 1;
+        splitLevels(0, height_);
+        tree_.resize((std::size_t(1) << height_) - 1);
+        std::size_t position[kMaxHeight] = {};
+        place(first, 1, 0, position);
+    }
+
+    template <typename Range, detail::EnableIfRange<Range> = 0>
+    explicit VebTree(const Range& sorted, Compare comp = {}) : VebTree(std::begin(sorted), std::end(sorted), comp) {}
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Levels of the tree.
+    int height() const { return height_; }
+
+    /// Bytes used by the tree, padding included.
+    std::size_t memoryBytes() const { return tree_.size() * sizeof(T); }
+
+    /// Sorted position of the first key not ordered before key (size() if none).
+    template <typename Key>
+    std::size_t lowerBound(const Key& key) const {
+        std::size_t candidate = 0;
+        return descend([&](const T& node) { return comp_(node, key); }, candidate);
+    }
+
+    /// Sorted position of the first key ordered after key (size() if none).
+    template <typename Key>
+    std::size_t upperBound(const Key& key) const {
+        std::size_t candidate = 0;
+        return descend([&](const T& node) { return !comp_(key, node); }, candidate);
+    }
+
+    /// Sorted position of a key equivalent to key, or search::npos.
+    template <typename Key>
+    std::size_t find(const Key& key) const {
+        std::size_t candidate = 0;
+        std::size_t position = descend([&](const T& node) { return comp_(node, key); }, candidate);
+        return (position < count_ && !comp_(key, tree_[candidate])) ? position : npos;
+    }
+
+private:
+    static constexpr int kMaxHeight = 64;
+
+    Compare comp_{};
+    std::size_t count_ = 0;
+    int height_ = 0;
+    std::vector<T, detail::AlignedAllocator<T>> tree_;
+    // How depth d is laid out: its nodes root bottom trees of bottomSize
+    // nodes, stored after the topSize-node top tree rooted at topDepth
+    struct Level {
+        std::size_t topSize;
+        std::size_t bottomSize;
+        std::size_t topDepth;
+    };
+    std::array<Level, kMaxHeight> levels_{};
+
+    // Records the cut of the subtree of the given height rooted at depth
+    // root, then the cuts inside its top and bottom halves
+    void splitLevels(int root, int height) {
+        if (height <= 1) {
+            return;
+        }
+        int top = height / 2;
+        int bottom = height - top;
+        levels_[root + top] = {(std::size_t(1) << top) - 1, (std::size_t(1) << bottom) - 1,
+                               static_cast<std::size_t>(root)};
+        splitLevels(root, top);
+        splitLevels(root + top, bottom);
+    }
+
+    std::size_t childPosition(const std::size_t* position, int depth, std::size_t bfs) const {
+        const Level& level = levels_[depth];
+        return position[level.topDepth] + level.topSize + (bfs & level.topSize) * level.bottomSize;
+    }
+
+    // Stores the key of BFS node bfs, then its subtrees; position[d] holds
+    // the layout position of the current path's node at depth d
+    template <typename RandomIt>
+    void place(RandomIt first, std::size_t bfs, int depth, std::size_t* position) {
+        std::size_t offset = bfs - (std::size_t(1) << depth);
+        std::size_t rank = ((2 * offset + 1) << (height_ - 1 - depth)) - 1;
+        tree_[position[depth]] = first[std::min(rank, count_ - 1)];
+        if (depth + 1 == height_) {
+            return;
+        }
+        for (std::size_t child = 2 * bfs; child <= 2 * bfs + 1; ++child) {
+            position[depth + 1] = childPosition(position, depth + 1, child);
+            place(first, child, depth + 1, position);
+        }
+    }
+
+    // Descends taking the right child while goRight(node). The leaf reached,
+    // less 2^h, is the in-order rank of the answer; candidate receives the
+    // slot of the last node that went left, which holds the answer's key.
+    template <typename GoRight>
+    std::size_t descend(GoRight goRight, std::size_t& candidate) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        std::size_t position[kMaxHeight];
+        position[0] = 0;
+        std::size_t bfs = 1;
+        std::size_t slot = 0;
+        for (int depth = 1;; ++depth) {
+            if (depth == height_) {
+                bfs = 2 * bfs + (goRight(tree_[slot]) ? 1 : 0);
+                candidate = (bfs & 1) ? candidate : slot;
+                break;
+            }
+            // Both children are known before the comparison; when they start
+            // new bottom trees their loads overlap it
+            std::size_t left = childPosition(position, depth, 2 * bfs);
+            std::size_t bottomSize = levels_[depth].bottomSize; // The right child's bottom tree follows
+            detail::prefetchElement(tree_.data(), left);
+            detail::prefetchElement(tree_.data(), left + bottomSize);
+            std::size_t right = goRight(tree_[slot]) ? 1 : 0;
+            candidate = right ? candidate : slot;
+            bfs = 2 * bfs + right;
+            slot = left + right * bottomSize;
+            position[depth] = slot;
+        }
+        return std::min(bfs - (std::size_t(1) << height_), count_);
+    }
+};
+
+} // namespace search
+
+#endif // VEB_TREE_HPP